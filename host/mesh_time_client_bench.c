@@ -0,0 +1,433 @@
+/*
+* Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*/
+
+
+/** @file
+ *
+ * Host benchmark of the mesh time client. For each HCI command and each status received from
+ * the Time Servers, the driver reports the number processed per second and the time per
+ * message. The commands are valid frames addressed to different servers, sent in rounds of
+ * BENCH_ROUND. Only the processing of the round is timed: the replies, the paced messages and
+ * the timers are run between the rounds. The time includes the SDK stand-ins (event allocation
+ * and the transport). The command lookup through the opcode index is also timed against the
+ * linear scan of the command table it replaced, over all opcodes of the mesh group, and the
+ * conversion of consecutive seconds to the date against the conversion which computes the
+ * calendar and divides for every second.
+ *
+ * Usage: mesh_time_client_bench [rounds]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "mesh_time_client.c"
+#include "mesh_time_client_host.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+#define BENCH_ROUND             16      // Messages timed together, one per destination
+#define BENCH_DEFAULT_ROUNDS    2000
+#define BENCH_DST               0x0100  // First destination
+#define BENCH_SETTLE_MS         60000   // Simulated time between the rounds, longer than all retries
+#define BENCH_DATE_START        (8825 * 86400ULL)   // 2024-02-29T00:00:00, converted seconds cross midnight
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+typedef struct
+{
+    uint16_t    opcode;
+    const char *name;
+} bench_name_t;
+
+/******************************************************
+ *          Variables Definitions
+ ******************************************************/
+static const bench_name_t bench_command_names[] =
+{
+    { HCI_CONTROL_MESH_COMMAND_TIME_GET,                    "TIME_GET" },
+    { HCI_CONTROL_MESH_COMMAND_TIME_SET,                    "TIME_SET" },
+    { HCI_CONTROL_MESH_COMMAND_TIME_ZONE_GET,               "TIME_ZONE_GET" },
+    { HCI_CONTROL_MESH_COMMAND_TIME_ZONE_SET,               "TIME_ZONE_SET" },
+    { HCI_CONTROL_MESH_COMMAND_TIME_TAI_UTC_DELTA_GET,      "TIME_TAI_UTC_DELTA_GET" },
+    { HCI_CONTROL_MESH_COMMAND_TIME_TAI_UTC_DELTA_SET,      "TIME_TAI_UTC_DELTA_SET" },
+    { HCI_CONTROL_MESH_COMMAND_TIME_ROLE_GET,               "TIME_ROLE_GET" },
+    { HCI_CONTROL_MESH_COMMAND_TIME_ROLE_SET,               "TIME_ROLE_SET" },
+    { HCI_CONTROL_MESH_COMMAND_TIME_GET_BATCH,              "TIME_GET_BATCH" },
+    { HCI_CONTROL_MESH_COMMAND_TIME_GET_CACHED,             "TIME_GET_CACHED" },
+    { HCI_CONTROL_MESH_COMMAND_TIME_SERVER_RANKING_GET,     "TIME_SERVER_RANKING_GET" },
+    { HCI_CONTROL_MESH_COMMAND_TIME_SYNC_SCHEDULER_SET,     "TIME_SYNC_SCHEDULER_SET" },
+    { HCI_CONTROL_MESH_COMMAND_TIME_SYNC_SCHEDULER_GET,     "TIME_SYNC_SCHEDULER_GET" },
+    { HCI_CONTROL_MESH_COMMAND_TIME_NOW_GET,                "TIME_NOW_GET" },
+    { HCI_CONTROL_MESH_COMMAND_LOCAL_TIME_GET,              "LOCAL_TIME_GET" },
+    { HCI_CONTROL_MESH_COMMAND_TIME_CLIENT_POOL_STATS_GET,  "TIME_CLIENT_POOL_STATS_GET" },
+    { HCI_CONTROL_MESH_COMMAND_TIME_CLIENT_STATS_GET,       "TIME_CLIENT_STATS_GET" },
+    { HCI_CONTROL_MESH_COMMAND_TIME_COMMAND_BATCH,          "TIME_COMMAND_BATCH" },
+    { HCI_CONTROL_MESH_COMMAND_TIME_PACING_SET,             "TIME_PACING_SET" },
+    { HCI_CONTROL_MESH_COMMAND_TIME_PACING_GET,             "TIME_PACING_GET" },
+    { HCI_CONTROL_MESH_COMMAND_TIME_LPN_SET,                "TIME_LPN_SET" },
+    { HCI_CONTROL_MESH_COMMAND_TIME_LPN_GET,                "TIME_LPN_GET" },
+    { HCI_CONTROL_MESH_COMMAND_TIME_PROXY_SET,              "TIME_PROXY_SET" },
+    { HCI_CONTROL_MESH_COMMAND_TIME_PROXY_GET,              "TIME_PROXY_GET" },
+    { HCI_CONTROL_MESH_COMMAND_TIME_ELECTION_START,         "TIME_ELECTION_START" },
+    { HCI_CONTROL_MESH_COMMAND_TIME_ELECTION_GET,           "TIME_ELECTION_GET" },
+    { HCI_CONTROL_MESH_COMMAND_TIME_CAPTURE_SET,            "TIME_CAPTURE_SET" },
+    { HCI_CONTROL_MESH_COMMAND_TIME_CAPTURE_GET,            "TIME_CAPTURE_GET" },
+};
+
+static const bench_name_t bench_status_names[] =
+{
+    { WICED_BT_MESH_TIME_STATUS,            "TIME_STATUS" },
+    { WICED_BT_MESH_TIME_ZONE_STATUS,       "TIME_ZONE_STATUS" },
+    { WICED_BT_MESH_TAI_UTC_DELTA_STATUS,   "TAI_UTC_DELTA_STATUS" },
+    { WICED_BT_MESH_TIME_ROLE_STATUS,       "TIME_ROLE_STATUS" },
+};
+
+static uint32_t bench_rounds = BENCH_DEFAULT_ROUNDS;
+
+/******************************************************
+ *          Function Definitions
+ ******************************************************/
+static uint64_t bench_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static const char *bench_name(const bench_name_t *p_names, uint32_t num, uint16_t opcode)
+{
+    uint32_t i;
+
+    for (i = 0; i < num; i++)
+    {
+        if (p_names[i].opcode == opcode)
+            return p_names[i].name;
+    }
+    return "?";
+}
+
+static void bench_report(const char *name, uint16_t opcode, uint64_t total_ns, uint32_t num)
+{
+    double ns = (double)total_ns / num;
+
+    printf("%-36s 0x%04x %10.1f ns %12.0f /s\n", name, opcode, ns, 1e9 / ns);
+}
+
+/*
+ * Deliver the status from the server
+ */
+static void bench_status(uint16_t event, uint16_t src)
+{
+    wiced_bt_mesh_time_state_msg_t            time_status;
+    wiced_bt_mesh_time_zone_status_t          zone_status;
+    wiced_bt_mesh_time_tai_utc_delta_status_t delta_status;
+    wiced_bt_mesh_time_role_msg_t             role_status;
+
+    switch (event)
+    {
+    case WICED_BT_MESH_TIME_STATUS:
+        host_time_status(src, 600000000 + wiced_host.tick_ms / 1000, 0, 2, 1);
+        break;
+    case WICED_BT_MESH_TIME_ZONE_STATUS:
+        memset(&zone_status, 0, sizeof(zone_status));
+        zone_status.time_zone_offset_current = MESH_TIME_ZONE_OFFSET_BIAS;
+        wiced_host_status_deliver(event, src, 0x0001, &zone_status);
+        break;
+    case WICED_BT_MESH_TAI_UTC_DELTA_STATUS:
+        memset(&delta_status, 0, sizeof(delta_status));
+        delta_status.tai_utc_delta_current = MESH_TIME_TAI_UTC_DELTA_BIAS + 37;
+        wiced_host_status_deliver(event, src, 0x0001, &delta_status);
+        break;
+    case WICED_BT_MESH_TIME_ROLE_STATUS:
+        role_status.role = MESH_TIME_ROLE_RELAY;
+        wiced_host_status_deliver(event, src, 0x0001, &role_status);
+        break;
+    default:
+        memset(&time_status, 0, sizeof(time_status));
+        wiced_host_status_deliver(event, src, 0x0001, &time_status);
+        break;
+    }
+}
+
+/*
+ * Complete the round: all servers addressed by the round reply with all statuses and the
+ * timers run, so the next round starts without pending messages
+ */
+static void bench_settle(void)
+{
+    uint16_t i;
+    uint8_t  j;
+
+    for (i = 0; i < BENCH_ROUND + 4; i++)
+    {
+        for (j = 0; j < sizeof(bench_status_names) / sizeof(bench_status_names[0]); j++)
+            bench_status(bench_status_names[j].opcode, BENCH_DST + i);
+    }
+    wiced_host_run(BENCH_SETTLE_MS);
+}
+
+/*
+ * Time the HCI command with the opcode
+ */
+static void bench_command(uint16_t opcode)
+{
+    uint8_t  frame[BENCH_ROUND][MESH_TIME_HOST_CMD_MAX_LEN];
+    uint32_t length[BENCH_ROUND];
+    uint64_t total_ns = 0;
+    uint64_t start;
+    uint32_t round;
+    uint16_t i;
+
+    for (i = 0; i < BENCH_ROUND; i++)
+        length[i] = host_command_frame(opcode, BENCH_DST + i, frame[i]);
+
+    // The time sources are known, so the cached gets and the proxy updates have the time
+    bench_settle();
+
+    for (round = 0; round < bench_rounds; round++)
+    {
+        start = bench_ns();
+        for (i = 0; i < BENCH_ROUND; i++)
+            mesh_app_proc_rx_cmd(opcode, frame[i], length[i]);
+        total_ns += bench_ns() - start;
+
+        bench_settle();
+    }
+    bench_report(bench_name(bench_command_names, sizeof(bench_command_names) / sizeof(bench_command_names[0]), opcode),
+                 opcode, total_ns, bench_rounds * BENCH_ROUND);
+}
+
+/*
+ * Time the status as the reply to the get sent by the host and as the unsolicited status
+ */
+static void bench_status_event(uint16_t event, wiced_bool_t reply)
+{
+    static const uint16_t get_opcode[] =
+    {
+        HCI_CONTROL_MESH_COMMAND_TIME_GET, HCI_CONTROL_MESH_COMMAND_TIME_ZONE_GET,
+        HCI_CONTROL_MESH_COMMAND_TIME_TAI_UTC_DELTA_GET, HCI_CONTROL_MESH_COMMAND_TIME_ROLE_GET
+    };
+    char     name[40];
+    uint64_t total_ns = 0;
+    uint64_t start;
+    uint32_t round;
+    uint16_t i;
+
+    for (round = 0; round < bench_rounds; round++)
+    {
+        if (reply)
+        {
+            for (i = 0; i < BENCH_ROUND; i++)
+                host_mesh_cmd(get_opcode[event - WICED_BT_MESH_TIME_STATUS], BENCH_DST + i, 1, NULL, 0);
+        }
+        start = bench_ns();
+        for (i = 0; i < BENCH_ROUND; i++)
+            bench_status(event, BENCH_DST + i);
+        total_ns += bench_ns() - start;
+
+        wiced_host_run(BENCH_SETTLE_MS);
+    }
+    snprintf(name, sizeof(name), "%s (%s)", bench_name(bench_status_names, sizeof(bench_status_names) / sizeof(bench_status_names[0]), event),
+             reply ? "reply" : "unsolicited");
+    bench_report(name, event, total_ns, bench_rounds * BENCH_ROUND);
+}
+
+/*
+ * Find the command by scanning the table
+ */
+static const mesh_time_command_t *bench_command_scan(uint16_t opcode)
+{
+    uint32_t i;
+
+    for (i = 0; i < sizeof(mesh_time_command_table) / sizeof(mesh_time_command_table[0]); i++)
+    {
+        if (mesh_time_command_table[i].opcode == opcode)
+            return &mesh_time_command_table[i];
+    }
+    return NULL;
+}
+
+/*
+ * Time the lookup of all opcodes of the mesh group, the ones not in the table included
+ */
+static void bench_lookup(const char *name, const mesh_time_command_t *(*p_find)(uint16_t opcode))
+{
+    const mesh_time_command_t *volatile p_cmd;
+    uint64_t total_ns = 0;
+    uint64_t start;
+    uint32_t round;
+    uint32_t found = 0;
+    uint16_t opcode;
+
+    for (round = 0; round < bench_rounds; round++)
+    {
+        start = bench_ns();
+        for (opcode = HCI_CONTROL_GROUP_MESH << 8; opcode <= ((HCI_CONTROL_GROUP_MESH << 8) | 0xFF); opcode++)
+        {
+            p_cmd = p_find(opcode);
+            found += (p_cmd != NULL);
+        }
+        total_ns += bench_ns() - start;
+    }
+    if (found != bench_rounds * (sizeof(mesh_time_command_table) / sizeof(mesh_time_command_table[0])))
+        printf("%s: %u commands found\n", name, found);
+    bench_report(name, HCI_CONTROL_GROUP_MESH << 8, total_ns, bench_rounds * 256);
+}
+
+/*
+ * Convert seconds to the date computing the calendar and dividing for every second
+ */
+static void bench_date_naive(uint64_t seconds, mesh_time_client_date_t *p_date)
+{
+    uint32_t days = (uint32_t)(seconds / MESH_TIME_SECONDS_PER_DAY);
+    uint32_t sod  = (uint32_t)(seconds % MESH_TIME_SECONDS_PER_DAY);
+    uint32_t era  = (days + MESH_TIME_DAYS_0000_03_01_TO_2000_01_01) / 146097;
+    uint32_t doe  = days + MESH_TIME_DAYS_0000_03_01_TO_2000_01_01 - era * 146097;
+    uint32_t yoe  = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    uint32_t doy  = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    uint32_t mp   = (5 * doy + 2) / 153;
+
+    p_date->day     = (uint8_t)(doy - (153 * mp + 2) / 5 + 1);
+    p_date->month   = (uint8_t)(mp < 10 ? mp + 3 : mp - 9);
+    p_date->year    = (uint16_t)(yoe + era * 400 + (p_date->month <= 2));
+    p_date->weekday = (uint8_t)((days + 6) % 7);
+    p_date->hour    = (uint8_t)(sod / 3600);
+    p_date->minute  = (uint8_t)(sod % 3600 / 60);
+    p_date->second  = (uint8_t)(sod % 60);
+}
+
+static uint32_t bench_date_sum(const mesh_time_client_date_t *p_date)
+{
+    return p_date->year + p_date->month + p_date->day + p_date->hour + p_date->minute + p_date->second + p_date->weekday;
+}
+
+/*
+ * Time the conversion of consecutive seconds with the day cache and with the naive conversion.
+ * Both conversions shall produce the same dates, the sums of the fields keep the loops.
+ */
+static void bench_date(void)
+{
+    mesh_time_client_date_t date;
+    mesh_time_client_date_t naive;
+    mesh_time_day_cache_t   cache;
+    uint64_t start;
+    uint64_t cached_ns;
+    uint64_t naive_ns;
+    uint64_t seconds;
+    uint64_t end = BENCH_DATE_START + (uint64_t)bench_rounds * 256;
+    uint32_t num_wrong = 0;
+
+    memset(&cache, 0xFF, sizeof(cache));
+    start = bench_ns();
+    for (seconds = BENCH_DATE_START; seconds < end; seconds++)
+    {
+        mesh_time_seconds_to_date(seconds, &cache, &date);
+        num_wrong += bench_date_sum(&date);
+    }
+    cached_ns = bench_ns() - start;
+
+    start = bench_ns();
+    for (seconds = BENCH_DATE_START; seconds < end; seconds++)
+    {
+        bench_date_naive(seconds, &naive);
+        num_wrong -= bench_date_sum(&naive);
+    }
+    naive_ns = bench_ns() - start;
+
+    memset(&cache, 0xFF, sizeof(cache));
+    for (seconds = BENCH_DATE_START; seconds < end; seconds++)
+    {
+        mesh_time_seconds_to_date(seconds, &cache, &date);
+        bench_date_naive(seconds, &naive);
+        num_wrong += (memcmp(&date, &naive, sizeof(date)) != 0);
+    }
+    if (num_wrong != 0)
+        printf("date conversion: %u dates differ\n", num_wrong);
+    bench_report("date conversion (day cache)", HCI_CONTROL_MESH_COMMAND_LOCAL_TIME_GET, cached_ns, bench_rounds * 256);
+    bench_report("date conversion (naive)", HCI_CONTROL_MESH_COMMAND_LOCAL_TIME_GET, naive_ns, bench_rounds * 256);
+}
+
+/*
+ * Run the benchmark in a child process started from the initialized application
+ */
+static void bench_run(uint16_t opcode, int status_event, wiced_bool_t reply)
+{
+    pid_t pid;
+
+    fflush(stdout);
+    if ((pid = fork()) == 0)
+    {
+        wiced_host_reset(1);
+        wiced_host.log_disabled = WICED_TRUE;
+        mesh_app_init(WICED_TRUE);
+        if (status_event)
+            bench_status_event(opcode, reply);
+        else
+            bench_command(opcode);
+        fflush(stdout);
+        _exit(0);
+    }
+    if (pid > 0)
+        waitpid(pid, NULL, 0);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t i;
+
+    if ((argc > 1) && (atoi(argv[1]) > 0))
+        bench_rounds = (uint32_t)atoi(argv[1]);
+
+    printf("%s: %u messages per opcode\n", MESH_TIME_HOST_CONFIG, bench_rounds * BENCH_ROUND);
+    wiced_host_reset(1);
+    wiced_host.log_disabled = WICED_TRUE;
+    mesh_app_init(WICED_TRUE);
+    bench_lookup("command lookup (index)", mesh_time_command_find);
+    bench_lookup("command lookup (scan)", bench_command_scan);
+    bench_date();
+
+    for (i = 0; i < sizeof(mesh_time_command_table) / sizeof(mesh_time_command_table[0]); i++)
+        bench_run(mesh_time_command_table[i].opcode, 0, WICED_FALSE);
+
+    for (i = 0; i < sizeof(bench_status_names) / sizeof(bench_status_names[0]); i++)
+    {
+        bench_run(bench_status_names[i].opcode, 1, WICED_TRUE);
+        bench_run(bench_status_names[i].opcode, 1, WICED_FALSE);
+    }
+    return 0;
+}
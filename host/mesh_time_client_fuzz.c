@@ -0,0 +1,203 @@
+/*
+* Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*/
+
+/** @file
+ *
+ * Fuzz harness of the HCI command length validation. Each frame is a valid frame of a command
+ * of the table cut at a random length, a valid frame with random bytes changed and random bytes
+ * appended, or random bytes. The frame is copied to a heap buffer of exactly its length, so a
+ * read past the length of the command is reported by the address sanitizer the driver is built
+ * with. Statuses from random servers are delivered and the timers run between the frames. At
+ * the end the mesh events and the HCI event buffers shall all be released.
+ *
+ * Usage: mesh_time_client_fuzz [-s seed] [-n frames]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "mesh_time_client.c"
+#include "mesh_time_client_host.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+#define FUZZ_DEFAULT_FRAMES     200000
+#define FUZZ_DST                0x0100  // First destination, the frames use 16 destinations
+#define FUZZ_MAX_APPEND         16      // Max number of random bytes appended to the valid frame
+#define FUZZ_MAX_RANDOM_LEN     64      // Max length of the random frame
+#define FUZZ_MAX_RUN_MS         5000    // Max simulated time between the frames
+#define FUZZ_SETTLE_MS          600000  // Simulated time at the end, longer than all retries and timeouts
+
+/******************************************************
+ *          Variables Definitions
+ ******************************************************/
+static uint32_t fuzz_state;
+static uint32_t fuzz_num_short;         // Frames shorter than the valid frame of the command
+
+/******************************************************
+ *          Function Definitions
+ ******************************************************/
+static uint32_t fuzz_rand(void)
+{
+    fuzz_state ^= fuzz_state << 13;
+    fuzz_state ^= fuzz_state >> 17;
+    fuzz_state ^= fuzz_state << 5;
+    return fuzz_state;
+}
+
+/*
+ * Send the frame from a buffer of exactly its length
+ */
+static void fuzz_frame_send(uint16_t opcode, const uint8_t *p_frame, uint32_t length)
+{
+    uint8_t *p_buf = (uint8_t *)malloc(length != 0 ? length : 1);
+
+    memcpy(p_buf, p_frame, length);
+    mesh_app_proc_rx_cmd(opcode, p_buf, length);
+    free(p_buf);
+}
+
+/*
+ * Deliver the status of a random type from a random server
+ */
+static void fuzz_status(void)
+{
+    wiced_bt_mesh_time_zone_status_t          zone_status;
+    wiced_bt_mesh_time_tai_utc_delta_status_t delta_status;
+    uint16_t src = FUZZ_DST + (fuzz_rand() & 0x0F);
+
+    switch (fuzz_rand() & 3)
+    {
+    case 0:
+        host_time_status(src, fuzz_rand(), (uint8_t)fuzz_rand(), (uint8_t)fuzz_rand(), fuzz_rand() & 1);
+        break;
+    case 1:
+        memset(&zone_status, 0, sizeof(zone_status));
+        zone_status.time_zone_offset_current = (uint8_t)fuzz_rand();
+        zone_status.time_zone_offset_new     = (uint8_t)fuzz_rand();
+        zone_status.tai_of_zone_change       = fuzz_rand() & 0xFFFF;
+        wiced_host_status_deliver(WICED_BT_MESH_TIME_ZONE_STATUS, src, 0x0001, &zone_status);
+        break;
+    case 2:
+        memset(&delta_status, 0, sizeof(delta_status));
+        delta_status.tai_utc_delta_current = (uint16_t)fuzz_rand();
+        delta_status.tai_utc_delta_new     = (uint16_t)fuzz_rand();
+        delta_status.tai_of_delta_change   = fuzz_rand() & 0xFFFF;
+        wiced_host_status_deliver(WICED_BT_MESH_TAI_UTC_DELTA_STATUS, src, 0x0001, &delta_status);
+        break;
+    default:
+        host_role_status(src, fuzz_rand() & 3);
+        break;
+    }
+}
+
+/*
+ * Build and send one frame
+ */
+static void fuzz_one(void)
+{
+    uint8_t  frame[MESH_TIME_HOST_CMD_MAX_LEN + FUZZ_MAX_APPEND];
+    uint32_t num_cmd = sizeof(mesh_time_command_table) / sizeof(mesh_time_command_table[0]);
+    uint16_t opcode = mesh_time_command_table[fuzz_rand() % num_cmd].opcode;
+    uint32_t valid_len;
+    uint32_t length;
+    uint32_t i;
+
+    valid_len = host_command_frame(opcode, FUZZ_DST + (fuzz_rand() & 0x0F), frame);
+
+    switch (fuzz_rand() % 3)
+    {
+    case 0:
+        length = fuzz_rand() % (valid_len + 1);
+        break;
+    case 1:
+        length = fuzz_rand() % (valid_len + FUZZ_MAX_APPEND + 1);
+        for (i = valid_len; i < length; i++)
+            frame[i] = (uint8_t)fuzz_rand();
+        for (i = fuzz_rand() % 4; i > 0 && length != 0; i--)
+            frame[fuzz_rand() % length] = (uint8_t)fuzz_rand();
+        break;
+    default:
+        length = fuzz_rand() % (FUZZ_MAX_RANDOM_LEN + 1);
+        for (i = 0; i < length; i++)
+            frame[i] = (uint8_t)fuzz_rand();
+        break;
+    }
+    if (length < valid_len)
+        fuzz_num_short++;
+
+    fuzz_frame_send(opcode, frame, length);
+
+    if ((fuzz_rand() & 3) == 0)
+        fuzz_status();
+    if ((fuzz_rand() & 7) == 0)
+        wiced_host_run(fuzz_rand() % FUZZ_MAX_RUN_MS);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t seed = 1;
+    uint32_t num_frames = FUZZ_DEFAULT_FRAMES;
+    uint32_t i;
+    int      opt;
+
+    while ((opt = getopt(argc, argv, "s:n:")) != -1)
+    {
+        if (opt == 's')
+            seed = (uint32_t)strtoul(optarg, NULL, 0);
+        else if (opt == 'n')
+            num_frames = (uint32_t)strtoul(optarg, NULL, 0);
+        else
+            return 1;
+    }
+    fuzz_state = (seed != 0) ? seed : 1;
+
+    wiced_host_reset(seed);
+    wiced_host.log_disabled = WICED_TRUE;
+    mesh_app_init(WICED_TRUE);
+
+    for (i = 0; i < num_frames; i++)
+        fuzz_one();
+    wiced_host_run(FUZZ_SETTLE_MS);
+
+    printf("%s: seed %u, %u frames, %u short, %u bad header, %u mesh tx, %u hci events\n", MESH_TIME_HOST_CONFIG, seed,
+           num_frames, fuzz_num_short, mesh_time_stats.num_bad_hdr, wiced_host.num_mesh_tx, wiced_host.num_hci_events);
+    if ((wiced_host.num_events_in_use != 0) || (wiced_host.num_hci_events_in_use != 0))
+    {
+        printf("%s: leak, %u mesh events and %u hci events in use\n", MESH_TIME_HOST_CONFIG,
+               wiced_host.num_events_in_use, wiced_host.num_hci_events_in_use);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,231 @@
+/*
+* Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*/
+
+
+/** @file
+ *
+ * Helpers shared by the host drivers of the mesh time client. The header is included after
+ * mesh_time_client.c, the helpers call the application as the mesh stack and the MCU do.
+ */
+#ifndef MESH_TIME_CLIENT_HOST_H
+#define MESH_TIME_CLIENT_HOST_H
+
+#include "wiced_host.h"
+
+#if LOW_POWER_NODE
+#define MESH_TIME_HOST_CONFIG_NODE      "lpn"
+#else
+#define MESH_TIME_HOST_CONFIG_NODE      "friend"
+#endif
+#if MESH_TIME_CLIENT_CAPTURE
+#define MESH_TIME_HOST_CONFIG           MESH_TIME_HOST_CONFIG_NODE "+capture"
+#else
+#define MESH_TIME_HOST_CONFIG           MESH_TIME_HOST_CONFIG_NODE
+#endif
+
+#define MESH_TIME_HOST_CMD_MAX_LEN      512     // Longest HCI command built by the drivers
+
+static inline uint16_t host_le16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t host_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/*
+ * Send HCI command without the mesh header
+ */
+static inline uint32_t host_cmd(uint16_t opcode, const uint8_t *p_param, uint32_t param_len)
+{
+    uint8_t buf[MESH_TIME_HOST_CMD_MAX_LEN];
+
+    if (param_len != 0)
+        memcpy(buf, p_param, param_len);
+    return mesh_app_proc_rx_cmd(opcode, buf, param_len);
+}
+
+/*
+ * Send HCI command with the mesh header addressed to the destination
+ */
+static inline uint32_t host_mesh_cmd(uint16_t opcode, uint16_t dst, uint8_t reply, const uint8_t *p_param, uint32_t param_len)
+{
+    uint8_t  buf[MESH_TIME_HOST_CMD_MAX_LEN];
+    uint8_t *p = wiced_host_mesh_hdr(buf, dst, 0, reply);
+
+    if (param_len != 0)
+        memcpy(p, p_param, param_len);
+    return mesh_app_proc_rx_cmd(opcode, buf, (uint32_t)(p - buf) + param_len);
+}
+
+/*
+ * Deliver Time Status from the server
+ */
+static inline void host_time_status(uint16_t src, uint64_t tai_seconds, uint8_t subsecond, uint8_t uncertainty, uint8_t authority)
+{
+    wiced_bt_mesh_time_state_msg_t status;
+
+    memset(&status, 0, sizeof(status));
+    status.tai_seconds               = tai_seconds;
+    status.subsecond                 = subsecond;
+    status.uncertainty               = uncertainty;
+    status.time_authority            = authority;
+    status.tai_utc_delta_current     = MESH_TIME_TAI_UTC_DELTA_BIAS + 37;
+    status.time_zone_offset_current  = MESH_TIME_ZONE_OFFSET_BIAS;
+    wiced_host_status_deliver(WICED_BT_MESH_TIME_STATUS, src, 0x0001, &status);
+}
+
+/*
+ * Deliver Time Role Status from the server
+ */
+static inline void host_role_status(uint16_t src, uint8_t role)
+{
+    wiced_bt_mesh_time_role_msg_t status;
+
+    status.role = role;
+    wiced_host_status_deliver(WICED_BT_MESH_TIME_ROLE_STATUS, src, 0x0001, &status);
+}
+
+/*
+ * Build the valid HCI command with the opcode addressed to the destination, as the MCU sends it.
+ * Returns the length of the command, 0 if the opcode is not known.
+ */
+static inline uint32_t host_command_frame(uint16_t opcode, uint16_t dst, uint8_t *p_buf)
+{
+    const mesh_time_command_t *p_cmd = mesh_time_command_find(opcode);
+    uint64_t tai = 600000000;
+    uint8_t *p = p_buf;
+    uint8_t  i;
+
+    if (p_cmd == NULL)
+        return 0;
+    if (p_cmd->flags & MESH_TIME_COMMAND_FLAG_MESH_HDR)
+        p = wiced_host_mesh_hdr(p, dst, 0, 1);
+
+    switch (opcode)
+    {
+    case HCI_CONTROL_MESH_COMMAND_TIME_SET:
+        UINT40_TO_STREAM(p, tai);
+        UINT8_TO_STREAM(p, 0);                  // subsecond
+        UINT8_TO_STREAM(p, 2);                  // uncertainty
+        UINT8_TO_STREAM(p, 1);                  // time authority
+        UINT16_TO_STREAM(p, MESH_TIME_TAI_UTC_DELTA_BIAS + 37);
+        UINT8_TO_STREAM(p, MESH_TIME_ZONE_OFFSET_BIAS);
+        break;
+    case HCI_CONTROL_MESH_COMMAND_TIME_ZONE_SET:
+        UINT8_TO_STREAM(p, MESH_TIME_ZONE_OFFSET_BIAS + 4);
+        UINT40_TO_STREAM(p, tai);
+        break;
+    case HCI_CONTROL_MESH_COMMAND_TIME_TAI_UTC_DELTA_SET:
+        UINT16_TO_STREAM(p, MESH_TIME_TAI_UTC_DELTA_BIAS + 38);
+        UINT40_TO_STREAM(p, tai);
+        break;
+    case HCI_CONTROL_MESH_COMMAND_TIME_ROLE_SET:
+        UINT8_TO_STREAM(p, MESH_TIME_ROLE_RELAY);
+        break;
+    case HCI_CONTROL_MESH_COMMAND_TIME_GET_BATCH:
+        UINT8_TO_STREAM(p, 5);                  // timeout
+        UINT8_TO_STREAM(p, 4);
+        for (i = 0; i < 4; i++)
+            UINT16_TO_STREAM(p, dst + i);
+        break;
+    case HCI_CONTROL_MESH_COMMAND_TIME_GET_CACHED:
+        UINT16_TO_STREAM(p, 60);                // max age
+        break;
+    case HCI_CONTROL_MESH_COMMAND_TIME_SYNC_SCHEDULER_SET:
+        UINT8_TO_STREAM(p, 1);
+        UINT16_TO_STREAM(p, 10);                // min interval
+        UINT16_TO_STREAM(p, 600);               // max interval
+        UINT16_TO_STREAM(p, 50);                // target accuracy
+        UINT8_TO_STREAM(p, 1);
+        UINT16_TO_STREAM(p, dst);
+        break;
+    case HCI_CONTROL_MESH_COMMAND_TIME_ELECTION_START:
+        UINT8_TO_STREAM(p, 1);                  // relays
+        UINT16_TO_STREAM(p, 0);                 // max score
+        UINT16_TO_STREAM(p, 60);                // monitoring interval
+        UINT8_TO_STREAM(p, 2);
+        UINT16_TO_STREAM(p, dst);
+        UINT16_TO_STREAM(p, dst + 1);
+        break;
+    case HCI_CONTROL_MESH_COMMAND_LOCAL_TIME_GET:
+        UINT40_TO_STREAM(p, tai);
+        break;
+    case HCI_CONTROL_MESH_COMMAND_TIME_CLIENT_POOL_STATS_GET:
+    case HCI_CONTROL_MESH_COMMAND_TIME_CLIENT_STATS_GET:
+        UINT8_TO_STREAM(p, 0);                  // keep the statistics
+        break;
+    case HCI_CONTROL_MESH_COMMAND_TIME_COMMAND_BATCH:
+        // Time Get and Time Role Set to the destination
+        UINT16_TO_STREAM(p, HCI_CONTROL_MESH_COMMAND_TIME_GET);
+        UINT8_TO_STREAM(p, WICED_HOST_MESH_HDR_LEN);
+        p = wiced_host_mesh_hdr(p, dst, 0, 1);
+        UINT16_TO_STREAM(p, HCI_CONTROL_MESH_COMMAND_TIME_ROLE_SET);
+        UINT8_TO_STREAM(p, WICED_HOST_MESH_HDR_LEN + MESH_TIME_ROLE_SET_PARAM_LEN);
+        p = wiced_host_mesh_hdr(p, dst, 0, 1);
+        UINT8_TO_STREAM(p, MESH_TIME_ROLE_CLIENT);
+        break;
+    case HCI_CONTROL_MESH_COMMAND_TIME_PACING_SET:
+        UINT8_TO_STREAM(p, MESH_TIME_PACE_DEFAULT_RATE);
+        UINT8_TO_STREAM(p, MESH_TIME_PACE_DEFAULT_BURST);
+        UINT16_TO_STREAM(p, MESH_TIME_PACE_DEFAULT_JITTER);
+        break;
+#if LOW_POWER_NODE
+    case HCI_CONTROL_MESH_COMMAND_TIME_LPN_SET:
+        UINT8_TO_STREAM(p, 0);
+        break;
+#else
+    case HCI_CONTROL_MESH_COMMAND_TIME_PROXY_SET:
+        UINT8_TO_STREAM(p, 0);                  // element
+        UINT16_TO_STREAM(p, 0);                 // application key index
+        UINT16_TO_STREAM(p, 1);                 // update every poll
+        UINT8_TO_STREAM(p, 1);
+        UINT16_TO_STREAM(p, dst);
+        UINT16_TO_STREAM(p, 50);                // poll interval 5 seconds
+        UINT16_TO_STREAM(p, 0);
+        break;
+#endif
+#if MESH_TIME_CLIENT_CAPTURE
+    case HCI_CONTROL_MESH_COMMAND_TIME_CAPTURE_SET:
+        UINT8_TO_STREAM(p, 1);
+        break;
+#endif
+    default:
+        break;
+    }
+    return (uint32_t)(p - p_buf);
+}
+
+#endif /* MESH_TIME_CLIENT_HOST_H */
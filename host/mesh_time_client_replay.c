@@ -0,0 +1,581 @@
+/*
+* Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*/
+
+/** @file
+ *
+ * Replay of input streams through the time client, two modes:
+ *
+ * drift: the Time Status replies of one Time Server to the periodic time sync, with the local
+ * clock of the client running fast by the injected drift and each reply delayed by a random hop
+ * delay. For each drift the driver reports the time after which the clock error stays within
+ * the target accuracy, the RMS and max error after that, the estimated drift and the final sync
+ * interval. With -v the error and the estimated drift are printed after each clock update. The
+ * driver fails if the clock does not converge or the estimated drift is off by more than
+ * REPLAY_DRIFT_TOLERANCE_PPM.
+ *
+ * capture: the HCI commands of a capture are passed to mesh_app_proc_rx_cmd at their recorded
+ * local time and the events produced by the client are compared with the recorded events. Each
+ * command is printed with its processing time, each event which differs is printed as recorded
+ * and as produced. Without the file a session of local commands and gets to silent servers is
+ * recorded first, -w saves it. Status messages received from the servers are not in the
+ * capture, so the events they caused are reported as missing. Only in the capture
+ * configuration. The driver fails if an event differs.
+ *
+ * Usage: mesh_time_client_replay [-s seed] [-t hours] [-v] drift [ppm ...]
+ *        mesh_time_client_replay [-s seed] [-w file] capture [file]
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "mesh_time_client.c"
+#include "mesh_time_client_host.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+#define REPLAY_SERVER_ADDR          0x0002
+#define REPLAY_TAI_START            600000000ULL
+#define REPLAY_HOP_LATENCY_MS       10      // Min delay of the get and of the reply
+#define REPLAY_HOP_JITTER_MS        20      // Random delay added to the min delay
+#define REPLAY_MAX_IN_FLIGHT        8       // Replies travelling to the client at the same time
+#define REPLAY_SAMPLE_INTERVAL_MS   1000    // Clock error is sampled every second
+#define REPLAY_DRIFT_TOLERANCE_PPM  10      // Max error of the estimated drift at the end of the run, the FLL settles within the delay jitter
+
+#define REPLAY_SYNC_MIN_INTERVAL    10      // Periodic time sync configuration of the client
+#define REPLAY_SYNC_MAX_INTERVAL    600
+#define REPLAY_SYNC_TARGET_MS       50
+
+#define REPLAY_MAX_EVENTS           256     // Events of one capture
+#define REPLAY_RECORD_STEP_MS       500     // Time between the commands of the recorded session
+#define REPLAY_RECORD_SETTLE_MS     30000   // Time after the last command, longer than all retries
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+typedef struct
+{
+    wiced_timer_t                   timer;
+    wiced_bt_mesh_time_state_msg_t  status;
+} replay_in_flight_t;
+
+typedef struct
+{
+    int32_t     drift_ppb;              // Local clock of the client runs fast by the drift
+    uint64_t    start_ms;
+    uint32_t    num_updates;            // Clock updates already printed
+    uint64_t    last_bad_ms;            // Last sample with the error above the target
+    uint32_t    num_samples;
+    double      sum_sq_us;
+    double      max_us;
+    wiced_timer_t sample_timer;
+} replay_drift_t;
+
+typedef struct
+{
+    uint16_t    opcode;
+    uint16_t    length;
+    uint32_t    time_ms;                // Local time relative to the capture start
+    uint8_t     data[WICED_HOST_HCI_EVENT_MAX_LEN];
+} replay_event_t;
+
+/******************************************************
+ *          Variables Definitions
+ ******************************************************/
+static replay_in_flight_t replay_in_flight[REPLAY_MAX_IN_FLIGHT];
+static replay_drift_t     replay_drift;
+#if MESH_TIME_CLIENT_CAPTURE
+static replay_event_t     replay_event[REPLAY_MAX_EVENTS];
+static uint32_t           replay_num_events;
+static uint64_t           replay_start_ms;
+#endif
+static uint32_t           replay_seed = 1;
+static wiced_bool_t       replay_verbose;
+static const char        *replay_write_file;    // Capture recorded by the replay is saved to the file
+
+/******************************************************
+ *          Drift
+ ******************************************************/
+
+/*
+ * True time in microseconds at the local time of the client
+ */
+static int64_t replay_true_us(uint64_t tick_ms)
+{
+    int64_t elapsed_ms = (int64_t)(tick_ms - replay_drift.start_ms);
+
+    return (int64_t)REPLAY_TAI_START * 1000000 + elapsed_ms * 1000 - (elapsed_ms * replay_drift.drift_ppb) / 1000000;
+}
+
+static void replay_deliver(TIMER_PARAM_TYPE arg)
+{
+    wiced_host_status_deliver(WICED_BT_MESH_TIME_STATUS, REPLAY_SERVER_ADDR, 0x0001, &replay_in_flight[arg].status);
+}
+
+/*
+ * Time Get reaches the server after the hop delay, the server reads the true time and the reply
+ * reaches the client after another hop delay
+ */
+static void replay_mesh_tx(const wiced_host_mesh_msg_t *p_msg)
+{
+    replay_in_flight_t *p_reply = NULL;
+    uint32_t delay_ms;
+    uint32_t reply_ms;
+    int64_t  time_us;
+    uint32_t i;
+
+    if ((p_msg->opcode != HCI_CONTROL_MESH_COMMAND_TIME_GET) || (p_msg->dst != REPLAY_SERVER_ADDR))
+        return;
+
+    for (i = 0; i < REPLAY_MAX_IN_FLIGHT; i++)
+    {
+        if (!wiced_is_timer_in_use(&replay_in_flight[i].timer))
+        {
+            p_reply = &replay_in_flight[i];
+            break;
+        }
+    }
+    if (p_reply == NULL)
+        return;
+
+    delay_ms = REPLAY_HOP_LATENCY_MS + wiced_hal_rand_gen_num() % (REPLAY_HOP_JITTER_MS + 1);
+    reply_ms = REPLAY_HOP_LATENCY_MS + wiced_hal_rand_gen_num() % (REPLAY_HOP_JITTER_MS + 1);
+    time_us  = replay_true_us(wiced_host.tick_ms + delay_ms);
+
+    memset(&p_reply->status, 0, sizeof(p_reply->status));
+    p_reply->status.tai_seconds              = (uint64_t)(time_us / 1000000);
+    p_reply->status.subsecond                = (uint8_t)(((time_us % 1000000) * 256) / 1000000);
+    p_reply->status.uncertainty              = 2;
+    p_reply->status.time_authority           = 1;
+    p_reply->status.tai_utc_delta_current    = MESH_TIME_TAI_UTC_DELTA_BIAS + 37;
+    p_reply->status.time_zone_offset_current = MESH_TIME_ZONE_OFFSET_BIAS;
+    wiced_start_timer(&p_reply->timer, delay_ms + reply_ms);
+}
+
+/*
+ * Sample the error of the client clock, print it after each clock update if verbose
+ */
+static void replay_sample(TIMER_PARAM_TYPE arg)
+{
+    int64_t slew_us;
+    double  error_us;
+
+    if (!mesh_time_clock.valid)
+    {
+        replay_drift.last_bad_ms = wiced_host.tick_ms;
+        return;
+    }
+    error_us = (double)(mesh_time_clock_at(wiced_host.tick_ms, &slew_us) - replay_true_us(wiced_host.tick_ms));
+    if (replay_verbose && (mesh_time_clock.num_updates != replay_drift.num_updates))
+    {
+        replay_drift.num_updates = mesh_time_clock.num_updates;
+        printf("%10.0f %6u %10.3f %9.3f\n", (double)(wiced_host.tick_ms - replay_drift.start_ms) / 1000,
+               mesh_time_sync.interval, error_us / 1000, -(double)mesh_time_clock.freq_ppb / 1000);
+    }
+    if (fabs(error_us) > REPLAY_SYNC_TARGET_MS * 1000)
+    {
+        replay_drift.last_bad_ms = wiced_host.tick_ms;
+        replay_drift.num_samples = 0;
+        replay_drift.sum_sq_us   = 0;
+        replay_drift.max_us      = 0;
+        return;
+    }
+    replay_drift.num_samples++;
+    replay_drift.sum_sq_us += error_us * error_us;
+    if (fabs(error_us) > replay_drift.max_us)
+        replay_drift.max_us = fabs(error_us);
+}
+
+/*
+ * Configure the periodic time sync with one server and run for the duration. Returns 0 if the
+ * clock converged and the drift has been estimated.
+ */
+static int replay_drift_run(int32_t drift_ppm, uint32_t hours)
+{
+    uint8_t  param[MESH_TIME_SYNC_SCHEDULER_SET_PARAM_LEN + 2];
+    uint8_t *p = param;
+    double   estimate_ppm;
+    uint32_t i;
+    int      converged;
+
+    replay_drift.drift_ppb   = drift_ppm * 1000;
+    replay_drift.start_ms    = wiced_host.tick_ms;
+    replay_drift.last_bad_ms = wiced_host.tick_ms;
+
+    for (i = 0; i < REPLAY_MAX_IN_FLIGHT; i++)
+        wiced_init_timer(&replay_in_flight[i].timer, replay_deliver, i, WICED_MILLI_SECONDS_TIMER);
+    wiced_init_timer(&replay_drift.sample_timer, replay_sample, 0, WICED_MILLI_SECONDS_PERIODIC_TIMER);
+    wiced_start_timer(&replay_drift.sample_timer, REPLAY_SAMPLE_INTERVAL_MS);
+    wiced_host.p_mesh_tx_cback = replay_mesh_tx;
+
+    UINT8_TO_STREAM(p, 1);
+    UINT16_TO_STREAM(p, REPLAY_SYNC_MIN_INTERVAL);
+    UINT16_TO_STREAM(p, REPLAY_SYNC_MAX_INTERVAL);
+    UINT16_TO_STREAM(p, REPLAY_SYNC_TARGET_MS);
+    UINT8_TO_STREAM(p, 1);
+    UINT16_TO_STREAM(p, REPLAY_SERVER_ADDR);
+    if (replay_verbose)
+        printf("drift %d ppm\n   time(s)  intvl  error(ms) est(ppm)\n", drift_ppm);
+    host_mesh_cmd(HCI_CONTROL_MESH_COMMAND_TIME_SYNC_SCHEDULER_SET, 0, 1, param, (uint32_t)(p - param));
+
+    wiced_host_run(hours * 3600 * 1000);
+
+    // Not converged if the error of the last sample is above the target
+    estimate_ppm = -(double)mesh_time_clock.freq_ppb / 1000;
+    converged = (replay_drift.num_samples != 0) && (fabs(estimate_ppm - drift_ppm) <= REPLAY_DRIFT_TOLERANCE_PPM);
+    printf("%9d %9.0f %8.1f %8.1f %9.3f %6u %6u %s\n", drift_ppm,
+           (replay_drift.num_samples != 0) ? (double)(replay_drift.last_bad_ms - replay_drift.start_ms) / 1000 : -1.0,
+           (replay_drift.num_samples != 0) ? sqrt(replay_drift.sum_sq_us / replay_drift.num_samples) / 1000 : -1.0,
+           (replay_drift.num_samples != 0) ? replay_drift.max_us / 1000 : -1.0,
+           estimate_ppm, mesh_time_sync.num_polls, mesh_time_sync.interval, converged ? "ok" : "FAIL");
+    return converged ? 0 : 1;
+}
+
+/*
+ * Run each drift in a child process started from the initialized application
+ */
+static int replay_drift_main(int argc, char *argv[], uint32_t hours)
+{
+    static const int32_t default_drift[] = { -200, -40, 0, 40, 200 };
+    int32_t  drift[16];
+    uint32_t num_drift = 0;
+    uint32_t i;
+    int      failed = 0;
+    int      status;
+    pid_t    pid;
+
+    for (; (optind < argc) && (num_drift < sizeof(drift) / sizeof(drift[0])); optind++)
+    {
+        drift[num_drift] = (int32_t)strtol(argv[optind], NULL, 0);
+        if ((drift[num_drift] < -MESH_TIME_CLOCK_MAX_FREQ_PPB / 1000) || (drift[num_drift] > MESH_TIME_CLOCK_MAX_FREQ_PPB / 1000))
+            return 1;
+        num_drift++;
+    }
+    if (num_drift == 0)
+    {
+        memcpy(drift, default_drift, sizeof(default_drift));
+        num_drift = sizeof(default_drift) / sizeof(default_drift[0]);
+    }
+
+    printf("%s: drift replay, seed %u, %u hours, target %u ms\n", MESH_TIME_HOST_CONFIG, replay_seed, hours, REPLAY_SYNC_TARGET_MS);
+    if (!replay_verbose)
+        printf("drift(ppm)  conv(s)  rms(ms)  max(ms)  est(ppm)  polls  intvl\n");
+    for (i = 0; i < num_drift; i++)
+    {
+        fflush(stdout);
+        if ((pid = fork()) == 0)
+        {
+            wiced_host_reset(replay_seed);
+            wiced_host.log_disabled = WICED_TRUE;
+            mesh_app_init(WICED_TRUE);
+            status = replay_drift_run(drift[i], hours);
+            fflush(stdout);
+            _exit(status);
+        }
+        if ((pid < 0) || (waitpid(pid, &status, 0) != pid) || !WIFEXITED(status) || (WEXITSTATUS(status) != 0))
+            failed = 1;
+    }
+    return failed;
+}
+
+/******************************************************
+ *          Capture
+ ******************************************************/
+#if MESH_TIME_CLIENT_CAPTURE
+static uint64_t replay_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/*
+ * Keep the event produced by the client if the capture would have recorded it
+ */
+static void replay_hci_event(uint16_t opcode, const uint8_t *p_data, uint16_t length)
+{
+    replay_event_t *p_event;
+
+    if ((opcode == HCI_CONTROL_MESH_EVENT_TIME_CAPTURE_DATA) || (opcode == HCI_CONTROL_MESH_EVENT_TIME_CLIENT_TRACE) ||
+        (replay_num_events >= REPLAY_MAX_EVENTS))
+        return;
+
+    p_event = &replay_event[replay_num_events++];
+    p_event->opcode  = opcode;
+    p_event->length  = (length < sizeof(p_event->data)) ? length : sizeof(p_event->data);
+    p_event->time_ms = (uint32_t)(wiced_host.tick_ms - replay_start_ms);
+    memcpy(p_event->data, p_data, p_event->length);
+}
+
+/*
+ * Reset the host and initialize the client. The pacing statistics are kept over the application
+ * init, they are reset so that the recording and the replay start from the same state.
+ */
+static void replay_init(void)
+{
+    uint8_t reset = 1;
+
+    wiced_host_reset(replay_seed);
+    wiced_host.log_disabled = WICED_TRUE;
+    mesh_app_init(WICED_TRUE);
+    mesh_time_pace_get(&reset, 1);
+}
+
+/*
+ * Record a session of local commands, sets and gets to servers which do not reply, so that
+ * all events can be reproduced by the replay. Returns the length of the capture.
+ */
+static uint32_t replay_record(uint8_t *p_buf)
+{
+    static const uint16_t session[] =
+    {
+        HCI_CONTROL_MESH_COMMAND_TIME_PACING_SET,
+        HCI_CONTROL_MESH_COMMAND_TIME_SET,
+        HCI_CONTROL_MESH_COMMAND_TIME_ZONE_SET,
+        HCI_CONTROL_MESH_COMMAND_TIME_GET,
+        HCI_CONTROL_MESH_COMMAND_TIME_ROLE_GET,
+        HCI_CONTROL_MESH_COMMAND_TIME_COMMAND_BATCH,
+        HCI_CONTROL_MESH_COMMAND_TIME_PACING_GET,
+        HCI_CONTROL_MESH_COMMAND_TIME_SYNC_SCHEDULER_GET,
+        HCI_CONTROL_MESH_COMMAND_TIME_NOW_GET,
+        HCI_CONTROL_MESH_COMMAND_LOCAL_TIME_GET,
+        HCI_CONTROL_MESH_COMMAND_TIME_SERVER_RANKING_GET,
+        HCI_CONTROL_MESH_COMMAND_TIME_ELECTION_GET,
+    };
+    uint8_t  frame[MESH_TIME_HOST_CMD_MAX_LEN];
+    uint32_t length;
+    uint32_t i;
+
+    replay_init();
+
+    length = host_command_frame(HCI_CONTROL_MESH_COMMAND_TIME_CAPTURE_SET, 0, frame);
+    mesh_app_proc_rx_cmd(HCI_CONTROL_MESH_COMMAND_TIME_CAPTURE_SET, frame, length);
+    for (i = 0; i < sizeof(session) / sizeof(session[0]); i++)
+    {
+        length = host_command_frame(session[i], REPLAY_SERVER_ADDR + i, frame);
+        mesh_app_proc_rx_cmd(session[i], frame, length);
+        wiced_host_run(REPLAY_RECORD_STEP_MS);
+    }
+    wiced_host_run(REPLAY_RECORD_SETTLE_MS);
+
+    if (mesh_time_capture.num_dropped != 0)
+        printf("%u frames not recorded, the capture buffer is full\n", mesh_time_capture.num_dropped);
+    memcpy(p_buf, mesh_time_capture.buf, mesh_time_capture.length);
+    return mesh_time_capture.length;
+}
+
+/*
+ * Print the recorded and the produced event if they differ. Returns 1 if they differ.
+ */
+static int replay_event_diff(uint32_t idx, const replay_event_t *p_rec, const replay_event_t *p_out)
+{
+    uint32_t i;
+
+    if ((p_rec != NULL) && (p_out != NULL) && (p_rec->opcode == p_out->opcode) && (p_rec->time_ms == p_out->time_ms) &&
+        (p_rec->length == p_out->length) && (memcmp(p_rec->data, p_out->data, p_rec->length) == 0))
+        return 0;
+
+    printf("event %3u differs\n", idx);
+    if (p_rec != NULL)
+        printf("  recorded  0x%04x at %8u ms, %u bytes\n", p_rec->opcode, p_rec->time_ms, p_rec->length);
+    else
+        printf("  recorded  none\n");
+    if (p_out != NULL)
+        printf("  produced  0x%04x at %8u ms, %u bytes\n", p_out->opcode, p_out->time_ms, p_out->length);
+    else
+        printf("  produced  none\n");
+    if ((p_rec != NULL) && (p_out != NULL) && (p_rec->opcode == p_out->opcode))
+    {
+        for (i = 0; (i < p_rec->length) && (i < p_out->length) && (p_rec->data[i] == p_out->data[i]); i++)
+            ;
+        printf("  first difference at byte %u\n", i);
+    }
+    return 1;
+}
+
+/*
+ * Pass the recorded commands to the freshly initialized client at their recorded local time and
+ * compare the events. Returns the number of events which differ, -1 if the capture is not valid.
+ */
+static int replay_capture(const uint8_t *p_buf, uint32_t length)
+{
+    static replay_event_t recorded[REPLAY_MAX_EVENTS];
+    uint8_t  frame[MESH_TIME_HOST_CMD_MAX_LEN];
+    uint32_t num_recorded = 0;
+    uint32_t num_cmd = 0;
+    uint32_t start_time;
+    uint32_t offset;
+    uint32_t time_ms = 0;
+    uint32_t i;
+    uint64_t ns;
+    uint64_t total_ns = 0;
+    uint64_t max_ns = 0;
+    uint16_t rec_len;
+    uint16_t opcode;
+    int      num_diff = 0;
+
+    if ((length < MESH_TIME_CAPTURE_HDR_LEN) || (memcmp(p_buf, "MTC1", 4) != 0))
+    {
+        printf("not a capture\n");
+        return -1;
+    }
+    start_time = host_le32(p_buf + 4);
+
+    replay_init();
+    replay_start_ms = wiced_host.tick_ms;
+    replay_num_events = 0;
+    wiced_host.p_hci_event_cback = replay_hci_event;
+
+    printf("  frame  time(ms)  opcode  length  proc(us)\n");
+    for (offset = MESH_TIME_CAPTURE_HDR_LEN; offset + MESH_TIME_CAPTURE_RECORD_HDR_LEN <= length; offset += rec_len)
+    {
+        rec_len = host_le16(p_buf + offset);
+        if ((rec_len < MESH_TIME_CAPTURE_RECORD_HDR_LEN) || (offset + rec_len > length))
+        {
+            printf("record at %u is truncated\n", offset);
+            return -1;
+        }
+        opcode  = host_le16(p_buf + offset + 3);
+        time_ms = host_le32(p_buf + offset + 5) - start_time;
+
+        if (p_buf[offset + 2] == MESH_TIME_CAPTURE_DIR_EVENT)
+        {
+            if (num_recorded < REPLAY_MAX_EVENTS)
+            {
+                recorded[num_recorded].opcode  = opcode;
+                recorded[num_recorded].time_ms = time_ms;
+                recorded[num_recorded].length  = rec_len - MESH_TIME_CAPTURE_RECORD_HDR_LEN;
+                memcpy(recorded[num_recorded].data, p_buf + offset + MESH_TIME_CAPTURE_RECORD_HDR_LEN, recorded[num_recorded].length);
+                num_recorded++;
+            }
+            continue;
+        }
+
+        // The client modifies nothing in the frame, a copy keeps the capture intact anyway
+        wiced_host_run_until(replay_start_ms + time_ms);
+        memcpy(frame, p_buf + offset + MESH_TIME_CAPTURE_RECORD_HDR_LEN, rec_len - MESH_TIME_CAPTURE_RECORD_HDR_LEN);
+        ns = replay_ns();
+        mesh_app_proc_rx_cmd(opcode, frame, rec_len - MESH_TIME_CAPTURE_RECORD_HDR_LEN);
+        ns = replay_ns() - ns;
+        total_ns += ns;
+        if (ns > max_ns)
+            max_ns = ns;
+        printf("  %5u %9u  0x%04x  %6u  %8.2f\n", num_cmd++, time_ms, opcode, rec_len - MESH_TIME_CAPTURE_RECORD_HDR_LEN, (double)ns / 1000);
+    }
+    wiced_host_run_until(replay_start_ms + time_ms);
+
+    for (i = 0; (i < num_recorded) || (i < replay_num_events); i++)
+        num_diff += replay_event_diff(i, (i < num_recorded) ? &recorded[i] : NULL, (i < replay_num_events) ? &replay_event[i] : NULL);
+
+    printf("%u commands, %u events recorded, %u produced, %d differ, processing avg %.2f us max %.2f us\n",
+           num_cmd, num_recorded, replay_num_events, num_diff,
+           (num_cmd != 0) ? (double)total_ns / num_cmd / 1000 : 0.0, (double)max_ns / 1000);
+    return num_diff;
+}
+
+static int replay_capture_main(int argc, char *argv[])
+{
+    static uint8_t buf[MESH_TIME_CAPTURE_BUF_SIZE];
+    uint32_t length;
+    FILE    *p_file;
+
+    if (optind < argc)
+    {
+        if ((p_file = fopen(argv[optind], "rb")) == NULL)
+        {
+            perror(argv[optind]);
+            return 1;
+        }
+        length = (uint32_t)fread(buf, 1, sizeof(buf), p_file);
+        fclose(p_file);
+        printf("%s: capture replay of %s, %u bytes\n", MESH_TIME_HOST_CONFIG, argv[optind], length);
+    }
+    else
+    {
+        length = replay_record(buf);
+        printf("%s: capture replay of the recorded session, seed %u, %u bytes\n", MESH_TIME_HOST_CONFIG, replay_seed, length);
+        if (replay_write_file != NULL)
+        {
+            if (((p_file = fopen(replay_write_file, "wb")) == NULL) || (fwrite(buf, 1, length, p_file) != length))
+            {
+                perror(replay_write_file);
+                return 1;
+            }
+            fclose(p_file);
+        }
+    }
+    return (replay_capture(buf, length) == 0) ? 0 : 1;
+}
+#endif
+
+int main(int argc, char *argv[])
+{
+    uint32_t hours = 6;
+    int      opt;
+
+    while ((opt = getopt(argc, argv, "s:t:vw:")) != -1)
+    {
+        if (opt == 's')
+            replay_seed = (uint32_t)strtoul(optarg, NULL, 0);
+        else if (opt == 't')
+            hours = (uint32_t)strtoul(optarg, NULL, 0);
+        else if (opt == 'v')
+            replay_verbose = WICED_TRUE;
+        else if (opt == 'w')
+            replay_write_file = optarg;
+        else
+            return 1;
+    }
+    if ((optind < argc) && (strcmp(argv[optind], "drift") == 0))
+    {
+        optind++;
+        return replay_drift_main(argc, argv, hours);
+    }
+    if ((optind < argc) && (strcmp(argv[optind], "capture") == 0))
+    {
+        optind++;
+#if MESH_TIME_CLIENT_CAPTURE
+        return replay_capture_main(argc, argv);
+#else
+        printf("%s: the capture replay needs the capture configuration\n", MESH_TIME_HOST_CONFIG);
+        return 1;
+#endif
+    }
+    fprintf(stderr, "usage: %s [-s seed] [-t hours] [-v] drift [ppm ...]\n"
+                    "       %s [-s seed] [-w file] capture [file]\n", argv[0], argv[0]);
+    return 1;
+}
@@ -0,0 +1,469 @@
+/*
+* Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*/
+
+
+/** @file
+ *
+ * Simulation of the time client in a mesh network of Time Servers. The servers form a relay
+ * tree with the Time Authority at the root. Each relay syncs its clock from its parent at a
+ * fixed interval, with the error of the hop delay asymmetry, and drifts between the syncs.
+ * Messages lose time on each hop and can be lost on each hop. All servers publish their time
+ * now and then, the statuses reach the client through mesh_time_client_message_handler as
+ * they do on the device.
+ *
+ * The client is attached to the deepest node of the tree. Its periodic time sync polls the
+ * attach node and its ancestors. For each network size the simulation reports the mesh messages
+ * per accepted clock update, counting every hop, the convergence time after which the clock stays
+ * within the target accuracy, and the RMS and max error of the clock after the convergence.
+ *
+ * Usage: mesh_time_client_sim [-s seed] [-t hours] [nodes ...], the default sizes are 10, 100,
+ * 1000 and 10000 nodes.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "mesh_time_client.c"
+#include "mesh_time_client_host.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+#define SIM_MAX_NODES           10000
+#define SIM_FANOUT              4       // Children of each relay
+#define SIM_CLIENT_ADDR         0x0001
+#define SIM_NODE_ADDR(i)        ((uint16_t)(0x0002 + (i)))
+#define SIM_TAI_START           600000000ULL
+
+#define SIM_HOP_LATENCY_MS      10      // Min delay of one hop
+#define SIM_HOP_JITTER_MS       20      // Random delay of one hop added to the min delay
+#define SIM_HOP_LOSS_PERMILLE   20      // Probability of the loss of a message on one hop
+#define SIM_NODE_DRIFT_PPM      50      // Max drift of the server clocks
+#define SIM_CLIENT_DRIFT_PPM    40      // Max drift of the client clock
+#define SIM_NODE_START_ERROR_MS 2000    // Max error of the server clocks before the first relay sync
+#define SIM_RELAY_INTERVAL_S    60      // Relay sync interval
+#define SIM_PUBLISH_INTERVAL_S  600     // Time Status publication interval of each server
+
+#define SIM_SYNC_MIN_INTERVAL   10      // Periodic time sync configuration of the client
+#define SIM_SYNC_MAX_INTERVAL   600
+#define SIM_SYNC_TARGET_MS      50
+
+#define SIM_MAX_IN_FLIGHT       256     // Statuses travelling to the client at the same time
+#define SIM_SAMPLE_INTERVAL_MS  1000    // Clock error is sampled every second
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+typedef struct
+{
+    int32_t     drift_ppb;
+    int32_t     start_error_us;
+    uint32_t    phase_ms;               // Time of the first relay sync
+    uint8_t     depth;
+} sim_node_t;
+
+typedef struct
+{
+    wiced_timer_t                   timer;
+    uint16_t                        src;
+    wiced_bt_mesh_time_state_msg_t  status;
+} sim_in_flight_t;
+
+typedef struct
+{
+    uint32_t    seed;
+    uint32_t    num_nodes;
+    uint32_t    attach;                 // Node the client is attached to
+    int32_t     client_drift_ppb;
+    uint64_t    start_ms;
+    uint64_t    num_hops;               // Hop transmissions of the gets and of the replies
+    uint64_t    num_publish_hops;       // Hop transmissions of the published statuses
+    uint32_t    num_gets;
+    uint32_t    num_replies;
+    uint32_t    num_published;
+    uint64_t    last_bad_ms;            // Last sample with the error above the target
+    uint32_t    num_samples;
+    double      sum_sq_us;
+    double      max_us;
+    wiced_timer_t publish_timer;
+    wiced_timer_t sample_timer;
+    uint32_t    publish_second;
+} sim_t;
+
+/******************************************************
+ *          Variables Definitions
+ ******************************************************/
+static sim_node_t      sim_node[SIM_MAX_NODES];
+static sim_in_flight_t sim_in_flight[SIM_MAX_IN_FLIGHT];
+static sim_t           sim;
+
+/******************************************************
+ *          Random numbers
+ ******************************************************/
+
+/*
+ * Random number derived from the seed and the arguments, so the relay syncs of the past can be
+ * evaluated again with the same result
+ */
+static uint64_t sim_hash(uint64_t a, uint64_t b, uint64_t c)
+{
+    uint64_t z = sim.seed * 0x9E3779B97F4A7C15ULL + a * 0xBF58476D1CE4E5B9ULL + b * 0x94D049BB133111EBULL + c;
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static uint32_t sim_uniform(uint64_t a, uint64_t b, uint64_t c, uint32_t range)
+{
+    return (uint32_t)(sim_hash(a, b, c) % range);
+}
+
+static uint32_t sim_rand(uint32_t range)
+{
+    return wiced_hal_rand_gen_num() % range;
+}
+
+static wiced_bool_t sim_hop_lost(void)
+{
+    return sim_rand(1000) < SIM_HOP_LOSS_PERMILLE;
+}
+
+/******************************************************
+ *          Network
+ ******************************************************/
+static uint32_t sim_parent(uint32_t node)
+{
+    return (node - 1) / SIM_FANOUT;
+}
+
+/*
+ * True time in microseconds at the local time of the client
+ */
+static int64_t sim_true_us(uint64_t tick_ms)
+{
+    int64_t elapsed_ms = (int64_t)(tick_ms - sim.start_ms);
+
+    return (int64_t)SIM_TAI_START * 1000000 + elapsed_ms * 1000 - (elapsed_ms * sim.client_drift_ppb) / 1000000;
+}
+
+/*
+ * Error of the server clock in microseconds at the local time. The root is the Time Authority.
+ * Other nodes copy the time of the parent at the last successful relay sync, with the error of
+ * the delay asymmetry of the hop, and drift since then.
+ */
+static int64_t sim_node_error_us(uint32_t node, uint64_t tick_ms)
+{
+    sim_node_t *p_node = &sim_node[node];
+    uint64_t elapsed_ms = tick_ms - sim.start_ms;
+    uint64_t sync_ms;
+    int64_t  k;
+
+    if (node == 0)
+        return 0;
+
+    k = (elapsed_ms < p_node->phase_ms) ? -1 : (int64_t)((elapsed_ms - p_node->phase_ms) / (SIM_RELAY_INTERVAL_S * 1000));
+
+    // Lost relay syncs keep the previous time
+    while ((k >= 0) && (sim_uniform(node, (uint64_t)k, 1, 1000) < 2 * SIM_HOP_LOSS_PERMILLE))
+        k--;
+
+    if (k < 0)
+        return p_node->start_error_us + ((int64_t)elapsed_ms * p_node->drift_ppb) / 1000000;
+
+    sync_ms = p_node->phase_ms + (uint64_t)k * SIM_RELAY_INTERVAL_S * 1000;
+    return sim_node_error_us(sim_parent(node), sim.start_ms + sync_ms) +
+           ((int64_t)sim_uniform(node, (uint64_t)k, 2, SIM_HOP_JITTER_MS * 1000) - SIM_HOP_JITTER_MS * 500) +
+           ((int64_t)(elapsed_ms - sync_ms) * p_node->drift_ppb) / 1000000;
+}
+
+/*
+ * Number of hops between two nodes of the tree
+ */
+static uint32_t sim_distance(uint32_t a, uint32_t b)
+{
+    uint32_t hops = 0;
+
+    while (a != b)
+    {
+        if (sim_node[a].depth >= sim_node[b].depth)
+            a = sim_parent(a);
+        else
+            b = sim_parent(b);
+        hops++;
+    }
+    return hops;
+}
+
+/*
+ * Delay of the message over the hops, 0 if the message is lost. Each hop transmission is counted.
+ */
+static uint32_t sim_travel(uint32_t hops, uint64_t *p_count)
+{
+    uint32_t delay_ms = 0;
+    uint32_t i;
+
+    for (i = 0; i < hops; i++)
+    {
+        (*p_count)++;
+        if (sim_hop_lost())
+            return 0;
+        delay_ms += SIM_HOP_LATENCY_MS + sim_rand(SIM_HOP_JITTER_MS + 1);
+    }
+    return delay_ms;
+}
+
+static void sim_deliver(TIMER_PARAM_TYPE arg)
+{
+    sim_in_flight_t *p_msg = &sim_in_flight[arg];
+
+    wiced_host_status_deliver(WICED_BT_MESH_TIME_STATUS, p_msg->src, SIM_CLIENT_ADDR, &p_msg->status);
+}
+
+/*
+ * Send Time Status of the node to the client. The time is read by the server when the status
+ * is sent, at the local time of the client tx_ms.
+ */
+static void sim_status_send(uint32_t node, uint64_t tx_ms, uint32_t delay_ms)
+{
+    sim_in_flight_t *p_msg = NULL;
+    int64_t  time_us = sim_true_us(tx_ms) + sim_node_error_us(node, tx_ms);
+    uint32_t i;
+
+    for (i = 0; i < SIM_MAX_IN_FLIGHT; i++)
+    {
+        if (!wiced_is_timer_in_use(&sim_in_flight[i].timer))
+        {
+            p_msg = &sim_in_flight[i];
+            break;
+        }
+    }
+    if (p_msg == NULL)
+        return;
+
+    memset(&p_msg->status, 0, sizeof(p_msg->status));
+    p_msg->src                              = SIM_NODE_ADDR(node);
+    p_msg->status.tai_seconds               = (uint64_t)(time_us / 1000000);
+    p_msg->status.subsecond                 = (uint8_t)(((time_us % 1000000) * 256) / 1000000);
+    p_msg->status.uncertainty               = (uint8_t)(2 + sim_node[node].depth * (SIM_HOP_JITTER_MS / 10));
+    p_msg->status.time_authority            = (node == 0);
+    p_msg->status.tai_utc_delta_current     = MESH_TIME_TAI_UTC_DELTA_BIAS + 37;
+    p_msg->status.time_zone_offset_current  = MESH_TIME_ZONE_OFFSET_BIAS;
+    wiced_start_timer(&p_msg->timer, delay_ms);
+}
+
+/*
+ * Time Get sent by the client travels to the server, the reply travels back
+ */
+static void sim_mesh_tx(const wiced_host_mesh_msg_t *p_msg)
+{
+    uint32_t node = (uint32_t)(p_msg->dst - SIM_NODE_ADDR(0));
+    uint32_t hops;
+    uint32_t delay_ms;
+    uint32_t reply_ms;
+
+    if ((p_msg->opcode != HCI_CONTROL_MESH_COMMAND_TIME_GET) || (node >= sim.num_nodes))
+        return;
+
+    sim.num_gets++;
+    hops = sim_distance(sim.attach, node) + 1;
+    if ((delay_ms = sim_travel(hops, &sim.num_hops)) == 0)
+        return;
+    if ((reply_ms = sim_travel(hops, &sim.num_hops)) == 0)
+        return;
+
+    sim.num_replies++;
+    sim_status_send(node, wiced_host.tick_ms + delay_ms, delay_ms + reply_ms);
+}
+
+/*
+ * Each second the nodes with the publication phase of the second publish their time
+ */
+static void sim_publish(TIMER_PARAM_TYPE arg)
+{
+    uint32_t node;
+    uint32_t delay_ms;
+
+    for (node = sim.publish_second; node < sim.num_nodes; node += SIM_PUBLISH_INTERVAL_S)
+    {
+        sim.num_published++;
+        if ((delay_ms = sim_travel(sim_distance(sim.attach, node) + 1, &sim.num_publish_hops)) != 0)
+            sim_status_send(node, wiced_host.tick_ms, delay_ms);
+    }
+    sim.publish_second = (sim.publish_second + 1) % SIM_PUBLISH_INTERVAL_S;
+}
+
+/*
+ * Sample the error of the client clock
+ */
+static void sim_sample(TIMER_PARAM_TYPE arg)
+{
+    int64_t slew_us;
+    double  error_us;
+
+    if (!mesh_time_clock.valid)
+    {
+        sim.last_bad_ms = wiced_host.tick_ms;
+        return;
+    }
+    error_us = (double)(mesh_time_clock_at(wiced_host.tick_ms, &slew_us) - sim_true_us(wiced_host.tick_ms));
+    if (fabs(error_us) > SIM_SYNC_TARGET_MS * 1000)
+    {
+        sim.last_bad_ms = wiced_host.tick_ms;
+        sim.num_samples = 0;
+        sim.sum_sq_us   = 0;
+        sim.max_us      = 0;
+        return;
+    }
+    sim.num_samples++;
+    sim.sum_sq_us += error_us * error_us;
+    if (fabs(error_us) > sim.max_us)
+        sim.max_us = fabs(error_us);
+}
+
+/*
+ * Build the network, configure the periodic time sync of the client and run for the duration
+ */
+static void sim_run(uint32_t num_nodes, uint32_t hours)
+{
+    uint8_t  param[MESH_TIME_SYNC_SCHEDULER_SET_PARAM_LEN + 2 * MESH_TIME_SYNC_MAX_SERVERS];
+    uint8_t *p = param;
+    uint8_t *p_num;
+    uint32_t node;
+    uint32_t i;
+
+    sim.num_nodes   = num_nodes;
+    sim.start_ms    = wiced_host.tick_ms;
+    sim.last_bad_ms = wiced_host.tick_ms;
+    sim.client_drift_ppb = (int32_t)sim_rand(2 * SIM_CLIENT_DRIFT_PPM * 1000 + 1) - SIM_CLIENT_DRIFT_PPM * 1000;
+
+    for (node = 0; node < num_nodes; node++)
+    {
+        sim_node[node].depth          = (node == 0) ? 0 : sim_node[sim_parent(node)].depth + 1;
+        sim_node[node].drift_ppb      = (int32_t)sim_rand(2 * SIM_NODE_DRIFT_PPM * 1000 + 1) - SIM_NODE_DRIFT_PPM * 1000;
+        sim_node[node].start_error_us = (int32_t)sim_rand(2 * SIM_NODE_START_ERROR_MS * 1000 + 1) - SIM_NODE_START_ERROR_MS * 1000;
+        sim_node[node].phase_ms       = sim_rand(SIM_RELAY_INTERVAL_S * 1000);
+    }
+    sim.attach = num_nodes - 1;
+
+    for (i = 0; i < SIM_MAX_IN_FLIGHT; i++)
+        wiced_init_timer(&sim_in_flight[i].timer, sim_deliver, i, WICED_MILLI_SECONDS_TIMER);
+    wiced_init_timer(&sim.publish_timer, sim_publish, 0, WICED_MILLI_SECONDS_PERIODIC_TIMER);
+    wiced_init_timer(&sim.sample_timer, sim_sample, 0, WICED_MILLI_SECONDS_PERIODIC_TIMER);
+    wiced_start_timer(&sim.publish_timer, 1000);
+    wiced_start_timer(&sim.sample_timer, SIM_SAMPLE_INTERVAL_MS);
+    wiced_host.p_mesh_tx_cback = sim_mesh_tx;
+
+    // The client polls the attach node and the nearest ancestors
+    UINT8_TO_STREAM(p, 1);
+    UINT16_TO_STREAM(p, SIM_SYNC_MIN_INTERVAL);
+    UINT16_TO_STREAM(p, SIM_SYNC_MAX_INTERVAL);
+    UINT16_TO_STREAM(p, SIM_SYNC_TARGET_MS);
+    p_num = p++;
+    *p_num = 0;
+    for (node = sim.attach; *p_num < MESH_TIME_SYNC_MAX_SERVERS; node = sim_parent(node))
+    {
+        UINT16_TO_STREAM(p, SIM_NODE_ADDR(node));
+        (*p_num)++;
+        if (node == 0)
+            break;
+    }
+    host_mesh_cmd(HCI_CONTROL_MESH_COMMAND_TIME_SYNC_SCHEDULER_SET, 0, 1, param, (uint32_t)(p - param));
+
+    wiced_host_run(hours * 3600 * 1000);
+
+    // Not converged if the error of the last sample is above the target
+    printf("%6u %5u %7u %9.1f %6u %9u %8.0f %8.1f %8.1f %6u\n", num_nodes, sim_node[sim.attach].depth, *p_num,
+           (mesh_time_sync.num_polls != 0) ? (double)sim.num_hops / mesh_time_sync.num_polls : 0.0,
+           mesh_time_sync.num_polls, sim.num_published,
+           (sim.num_samples != 0) ? (double)(sim.last_bad_ms - sim.start_ms) / 1000 : -1.0,
+           (sim.num_samples != 0) ? sqrt(sim.sum_sq_us / sim.num_samples) / 1000 : -1.0,
+           (sim.num_samples != 0) ? sim.max_us / 1000 : -1.0,
+           mesh_time_sync.interval);
+}
+
+int main(int argc, char *argv[])
+{
+    static const uint32_t default_sizes[] = { 10, 100, 1000, 10000 };
+    uint32_t sizes[16];
+    uint32_t num_sizes = 0;
+    uint32_t seed = 1;
+    uint32_t hours = 2;
+    uint32_t i;
+    pid_t    pid;
+    int      opt;
+
+    while ((opt = getopt(argc, argv, "s:t:")) != -1)
+    {
+        if (opt == 's')
+            seed = (uint32_t)strtoul(optarg, NULL, 0);
+        else if (opt == 't')
+            hours = (uint32_t)strtoul(optarg, NULL, 0);
+        else
+            return 1;
+    }
+    for (; (optind < argc) && (num_sizes < sizeof(sizes) / sizeof(sizes[0])); optind++)
+    {
+        sizes[num_sizes] = (uint32_t)strtoul(argv[optind], NULL, 0);
+        if ((sizes[num_sizes] == 0) || (sizes[num_sizes] > SIM_MAX_NODES))
+            return 1;
+        num_sizes++;
+    }
+    if (num_sizes == 0)
+    {
+        memcpy(sizes, default_sizes, sizeof(default_sizes));
+        num_sizes = sizeof(default_sizes) / sizeof(default_sizes[0]);
+    }
+
+    printf("%s: seed %u, %u hours, target %u ms\n", MESH_TIME_HOST_CONFIG, seed, hours, SIM_SYNC_TARGET_MS);
+    printf(" nodes depth servers msgs/sync  polls published  conv(s)  rms(ms)  max(ms)  intvl\n");
+    for (i = 0; i < num_sizes; i++)
+    {
+        fflush(stdout);
+        if ((pid = fork()) == 0)
+        {
+            wiced_host_reset(seed);
+            wiced_host.log_disabled = WICED_TRUE;
+            sim.seed = seed;
+            mesh_app_init(WICED_TRUE);
+            sim_run(sizes[i], hours);
+            fflush(stdout);
+            _exit(0);
+        }
+        if (pid > 0)
+            waitpid(pid, NULL, 0);
+    }
+    return 0;
+}
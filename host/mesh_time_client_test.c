@@ -0,0 +1,899 @@
+/*
+* Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*/
+
+/** @file
+ *
+ * Host tests of the mesh time client. The application source is included, so that the tests
+ * can check the internal state. Each test runs in its own process started from the clean
+ * state, after the application initialization of a provisioned node.
+ *
+ * Usage: mesh_time_client_test [name ...], runs the tests with the names containing one of
+ * the arguments, or all tests.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "mesh_time_client.c"
+#include "mesh_time_client_host.h"
+
+/******************************************************
+ *          Test framework
+ ******************************************************/
+#define TEST_CHECK(cond) \
+    do { if (!(cond)) { printf("  %s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); test_failed = 1; } } while (0)
+
+#define TEST_CHECK_EQ(a, b) \
+    do { long long _a = (long long)(a), _b = (long long)(b); \
+         if (_a != _b) { printf("  %s:%d: check failed: %s == %s (%lld != %lld)\n", __FILE__, __LINE__, #a, #b, _a, _b); test_failed = 1; } } while (0)
+
+typedef struct
+{
+    const char  *name;
+    void       (*p_test)(void);
+} test_case_t;
+
+static int test_failed;
+
+/******************************************************
+ *          Tests
+ ******************************************************/
+
+/*
+ * All commands of the table are found by the opcode, other opcodes are rejected, also the ones
+ * of other groups with the low byte of a command
+ */
+static void test_command_find(void)
+{
+    uint32_t num_indexed = 0;
+    uint32_t i;
+
+    for (i = 0; i < sizeof(mesh_time_command_table) / sizeof(mesh_time_command_table[0]); i++)
+        TEST_CHECK(mesh_time_command_find(mesh_time_command_table[i].opcode) == &mesh_time_command_table[i]);
+    for (i = 0; i < sizeof(mesh_time_command_index); i++)
+        num_indexed += (mesh_time_command_index[i] != 0);
+    TEST_CHECK_EQ(num_indexed, sizeof(mesh_time_command_table) / sizeof(mesh_time_command_table[0]));
+
+    TEST_CHECK(mesh_time_command_find(0x0000) == NULL);
+    TEST_CHECK(mesh_time_command_find(((HCI_CONTROL_GROUP_MESH + 1) << 8) | (HCI_CONTROL_MESH_COMMAND_TIME_GET & 0xFF)) == NULL);
+    TEST_CHECK(mesh_time_command_find((HCI_CONTROL_GROUP_MESH << 8) | 0xFF) == NULL);
+    TEST_CHECK_EQ(mesh_app_proc_rx_cmd((HCI_CONTROL_GROUP_MESH << 8) | 0xFF, NULL, 0), WICED_FALSE);
+    TEST_CHECK_EQ(mesh_time_stats.num_unknown_cmd, 1);
+}
+
+/*
+ * Time Get is sent to the server and the status is reported to the host
+ */
+static void test_time_get(void)
+{
+    const wiced_host_hci_event_t *p_event;
+
+    host_mesh_cmd(HCI_CONTROL_MESH_COMMAND_TIME_GET, 0x0002, 1, NULL, 0);
+    TEST_CHECK_EQ(wiced_host_mesh_tx_count(HCI_CONTROL_MESH_COMMAND_TIME_GET, 0x0002, 0), 1);
+
+    wiced_host_run(30);
+    host_time_status(0x0002, 600000000, 0x80, 2, 1);
+
+    p_event = wiced_host_hci_event_find(HCI_CONTROL_MESH_EVENT_TIME_STATUS, 0);
+    TEST_CHECK(p_event != NULL);
+    if (p_event != NULL)
+    {
+        TEST_CHECK_EQ(p_event->length, 5 + MESH_TIME_STATE_MSG_LEN);
+        TEST_CHECK_EQ(host_le16(p_event->data), 0x0002);
+        TEST_CHECK_EQ(host_le32(p_event->data + 5), 600000000);
+        TEST_CHECK_EQ(p_event->data[10], 0x80);
+    }
+    TEST_CHECK_EQ(mesh_time_stats.opcode[0].num_reply, 1);
+}
+
+/*
+ * Second get to the same server is coalesced and both host requests receive the status
+ */
+static void test_time_get_coalesced(void)
+{
+    host_mesh_cmd(HCI_CONTROL_MESH_COMMAND_TIME_GET, 0x0002, 1, NULL, 0);
+    host_mesh_cmd(HCI_CONTROL_MESH_COMMAND_TIME_GET, 0x0002, 1, NULL, 0);
+    TEST_CHECK_EQ(wiced_host_mesh_tx_count(HCI_CONTROL_MESH_COMMAND_TIME_GET, 0x0002, 0), 1);
+
+    host_time_status(0x0002, 600000000, 0, 2, 1);
+    TEST_CHECK_EQ(wiced_host_hci_event_count(HCI_CONTROL_MESH_EVENT_TIME_STATUS, 0), 2);
+}
+
+/*
+ * Unanswered get is retried with doubled timeout and reported as timed out after all retries
+ */
+static void test_time_get_timeout(void)
+{
+    const wiced_host_hci_event_t *p_event;
+
+    host_mesh_cmd(HCI_CONTROL_MESH_COMMAND_TIME_GET, 0x0002, 1, NULL, 0);
+
+    wiced_host_run(MESH_TIME_REQUEST_TIMEOUT);
+    TEST_CHECK_EQ(wiced_host_mesh_tx_count(HCI_CONTROL_MESH_COMMAND_TIME_GET, 0x0002, 0), 2);
+    wiced_host_run(2 * MESH_TIME_REQUEST_TIMEOUT);
+    TEST_CHECK_EQ(wiced_host_mesh_tx_count(HCI_CONTROL_MESH_COMMAND_TIME_GET, 0x0002, 0), 3);
+    TEST_CHECK_EQ(wiced_host_hci_event_count(HCI_CONTROL_MESH_EVENT_TIME_REQUEST_TIMEOUT, 0), 0);
+    wiced_host_run(4 * MESH_TIME_REQUEST_TIMEOUT);
+
+    p_event = wiced_host_hci_event_find(HCI_CONTROL_MESH_EVENT_TIME_REQUEST_TIMEOUT, 0);
+    TEST_CHECK(p_event != NULL);
+    if (p_event != NULL)
+        TEST_CHECK_EQ(host_le16(p_event->data + 5), HCI_CONTROL_MESH_COMMAND_TIME_GET);
+    TEST_CHECK_EQ(mesh_time_stats.opcode[0].num_retry, 2);
+    TEST_CHECK_EQ(mesh_time_stats.opcode[0].num_lost, 1);
+}
+
+/*
+ * Gets do not create server entries, the round trip is measured from the send time kept by
+ * the request tracker, and statuses from many servers do not evict the source or the servers
+ * with samples
+ */
+static void test_server_table(void)
+{
+    mesh_time_server_t *p_server;
+    int i;
+
+    host_mesh_cmd(HCI_CONTROL_MESH_COMMAND_TIME_GET, 0x0002, 1, NULL, 0);
+    TEST_CHECK(mesh_time_server_find(0x0002, MESH_TIME_SERVER_FIND) == NULL);
+    wiced_host_run(120);
+    host_time_status(0x0002, 1000, 0, 0, 1);
+    p_server = mesh_time_server_find(0x0002, MESH_TIME_SERVER_FIND);
+    TEST_CHECK(p_server != NULL);
+    if (p_server != NULL)
+    {
+        TEST_CHECK_EQ(p_server->num_samples, 1);
+        TEST_CHECK_EQ(p_server->sample[0].delay_ms, 120);
+    }
+    TEST_CHECK_EQ(mesh_time_clock.source, 0x0002);
+
+    // The reply to a retried get cannot be matched with one transmission
+    host_mesh_cmd(HCI_CONTROL_MESH_COMMAND_TIME_GET, 0x0003, 1, NULL, 0);
+    wiced_host_run(MESH_TIME_REQUEST_TIMEOUT + 50);
+    host_time_status(0x0003, 1010, 0, 0, 0);
+    p_server = mesh_time_server_find(0x0003, MESH_TIME_SERVER_FIND);
+    TEST_CHECK(p_server != NULL);
+    if (p_server != NULL)
+        TEST_CHECK_EQ(p_server->num_samples, 0);
+
+    for (i = 0; i < 2 * MESH_TIME_CLIENT_MAX_SERVERS; i++)
+        host_time_status(0x0100 + i, 1020, 0, 0, 0);
+    TEST_CHECK(mesh_time_server_find(0x0002, MESH_TIME_SERVER_FIND) != NULL);
+    TEST_CHECK_EQ(mesh_time_clock.source, 0x0002);
+    TEST_CHECK(mesh_time_server_find(0x0100 + 2 * MESH_TIME_CLIENT_MAX_SERVERS - 1, MESH_TIME_SERVER_FIND) != NULL);
+
+    // Servers which receive a sample replace the oldest entries with samples, not the source
+    for (i = 0; i < MESH_TIME_CLIENT_MAX_SERVERS; i++)
+    {
+        host_mesh_cmd(HCI_CONTROL_MESH_COMMAND_TIME_GET, 0x0200 + i, 1, NULL, 0);
+        wiced_host_run(100);
+        host_time_status(0x0200 + i, 1030, 0, 10, 0);
+    }
+    TEST_CHECK_EQ(mesh_time_clock.source, 0x0002);
+    TEST_CHECK(mesh_time_server_find(0x0002, MESH_TIME_SERVER_FIND) != NULL);
+    TEST_CHECK(mesh_time_server_find(0x0200 + MESH_TIME_CLIENT_MAX_SERVERS - 1, MESH_TIME_SERVER_FIND) != NULL);
+    TEST_CHECK(mesh_time_server_find(0x0200, MESH_TIME_SERVER_FIND) == NULL);
+}
+
+/*
+ * Commands shorter than the header or the fixed parameters are not executed
+ */
+static void test_command_length(void)
+{
+    uint8_t param[MESH_TIME_SET_PARAM_LEN];
+
+    memset(param, 0, sizeof(param));
+    host_mesh_cmd(HCI_CONTROL_MESH_COMMAND_TIME_SET, 0x0002, 0, param, sizeof(param) - 1);
+    TEST_CHECK_EQ(mesh_app_proc_rx_cmd(HCI_CONTROL_MESH_COMMAND_TIME_GET, param, WICED_HOST_MESH_HDR_LEN - 1), WICED_TRUE);
+    TEST_CHECK_EQ(wiced_host.num_mesh_tx, 0);
+    TEST_CHECK_EQ(mesh_time_stats.num_bad_hdr, 1);
+
+    host_mesh_cmd(HCI_CONTROL_MESH_COMMAND_TIME_SET, 0x0002, 0, param, sizeof(param));
+    wiced_host_run(MESH_TIME_PACE_DEFAULT_JITTER);
+    TEST_CHECK_EQ(wiced_host_mesh_tx_count(HCI_CONTROL_MESH_COMMAND_TIME_SET, 0x0002, 0), 1);
+}
+
+/*
+ * Sets are sent in a burst up to the bucket size, the rest at the configured rate
+ */
+static void test_pacing(void)
+{
+    uint8_t param[MESH_TIME_SET_PARAM_LEN];
+    uint16_t i;
+
+    memset(param, 0, sizeof(param));
+    for (i = 0; i < 8; i++)
+        host_mesh_cmd(HCI_CONTROL_MESH_COMMAND_TIME_SET, 0x0010 + i, 0, param, sizeof(param));
+
+    // The first message waits for the random delay
+    wiced_host_run(MESH_TIME_PACE_DEFAULT_JITTER);
+    TEST_CHECK(wiced_host.num_mesh_tx >= 1);
+    TEST_CHECK(wiced_host.num_mesh_tx <= MESH_TIME_PACE_DEFAULT_BURST);
+
+    wiced_host_run(1000);
+    TEST_CHECK_EQ(wiced_host.num_mesh_tx, 8);
+    TEST_CHECK_EQ(mesh_time_pace.num_sent, 8);
+    TEST_CHECK_EQ(mesh_time_pace.depth, 0);
+}
+
+/*
+ * Sets of the command batch waiting for the pacing tokens are reported as queued, not as sent
+ */
+static void test_command_batch(void)
+{
+    const wiced_host_hci_event_t *p_event;
+    uint8_t  pacing[] = { MESH_TIME_PACE_DEFAULT_RATE, 1, 0, 0 };
+    uint8_t  param[3 * (3 + WICED_HOST_MESH_HDR_LEN + MESH_TIME_SET_PARAM_LEN)];
+    uint8_t *p = param;
+    uint16_t i;
+
+    host_cmd(HCI_CONTROL_MESH_COMMAND_TIME_PACING_SET, pacing, sizeof(pacing));
+    for (i = 0; i < 2; i++)
+    {
+        UINT16_TO_STREAM(p, HCI_CONTROL_MESH_COMMAND_TIME_SET);
+        UINT8_TO_STREAM(p, WICED_HOST_MESH_HDR_LEN + MESH_TIME_SET_PARAM_LEN);
+        p = wiced_host_mesh_hdr(p, 0x0050 + i, 0, 0);
+        memset(p, 0, MESH_TIME_SET_PARAM_LEN);
+        p += MESH_TIME_SET_PARAM_LEN;
+    }
+    UINT16_TO_STREAM(p, HCI_CONTROL_MESH_COMMAND_TIME_GET);
+    UINT8_TO_STREAM(p, WICED_HOST_MESH_HDR_LEN);
+    p = wiced_host_mesh_hdr(p, 0x0052, 0, 1);
+    host_cmd(HCI_CONTROL_MESH_COMMAND_TIME_COMMAND_BATCH, param, (uint32_t)(p - param));
+
+    p_event = wiced_host_hci_event_find(HCI_CONTROL_MESH_EVENT_TIME_COMMAND_BATCH_STATUS, 0);
+    TEST_CHECK(p_event != NULL);
+    if (p_event != NULL)
+    {
+        TEST_CHECK_EQ(p_event->data[5], 3);
+        TEST_CHECK_EQ(p_event->data[6], 0x05);
+        TEST_CHECK_EQ(p_event->data[7], 0x02);
+    }
+    TEST_CHECK_EQ(wiced_host_mesh_tx_count(HCI_CONTROL_MESH_COMMAND_TIME_SET, 0x0051, 0), 0);
+
+    wiced_host_run(1000);
+    TEST_CHECK_EQ(wiced_host_mesh_tx_count(HCI_CONTROL_MESH_COMMAND_TIME_SET, 0x0051, 0), 1);
+}
+
+/*
+ * Batch get is reported in one event when all servers replied
+ */
+static void test_batch_get(void)
+{
+    const wiced_host_hci_event_t *p_event;
+    uint8_t  param[2 + 3 * 2];
+    uint8_t *p = param;
+    uint16_t i;
+
+    UINT8_TO_STREAM(p, 5);
+    UINT8_TO_STREAM(p, 3);
+    for (i = 0; i < 3; i++)
+        UINT16_TO_STREAM(p, 0x0020 + i);
+    host_mesh_cmd(HCI_CONTROL_MESH_COMMAND_TIME_GET_BATCH, 0, 0, param, sizeof(param));
+    wiced_host_run(1000);
+    TEST_CHECK_EQ(wiced_host_mesh_tx_count(HCI_CONTROL_MESH_COMMAND_TIME_GET, 0, 0), 3);
+
+    for (i = 0; i < 3; i++)
+        host_time_status(0x0020 + i, 600000000 + i, 0, 2, 1);
+
+    p_event = wiced_host_hci_event_find(HCI_CONTROL_MESH_EVENT_TIME_GET_BATCH_STATUS, 0);
+    TEST_CHECK(p_event != NULL);
+    if (p_event != NULL)
+    {
+        TEST_CHECK_EQ(p_event->data[5], 3);
+        TEST_CHECK_EQ(p_event->data[7], 3);
+        TEST_CHECK_EQ(host_le16(p_event->data + 8 + 14), 0x0021);
+        TEST_CHECK_EQ(p_event->data[8 + 14 + 2], 1);
+    }
+    TEST_CHECK_EQ(wiced_host_hci_event_count(HCI_CONTROL_MESH_EVENT_TIME_STATUS, 0), 0);
+    TEST_CHECK_EQ(mesh_time_batch.in_progress, WICED_FALSE);
+}
+
+/*
+ * Batch gets are tracked and retried as the host gets, the batch is reported when the last
+ * server replied to the retry
+ */
+static void test_batch_get_retry(void)
+{
+    const wiced_host_hci_event_t *p_event;
+    uint8_t  param[2 + 2 * 2];
+    uint8_t *p = param;
+
+    UINT8_TO_STREAM(p, 0);
+    UINT8_TO_STREAM(p, 2);
+    UINT16_TO_STREAM(p, 0x0030);
+    UINT16_TO_STREAM(p, 0x0031);
+    host_mesh_cmd(HCI_CONTROL_MESH_COMMAND_TIME_GET_BATCH, 0, 0, param, sizeof(param));
+    wiced_host_run(1000);
+    host_time_status(0x0030, 600000000, 0, 2, 1);
+
+    wiced_host_run(MESH_TIME_REQUEST_TIMEOUT);
+    TEST_CHECK_EQ(wiced_host_mesh_tx_count(HCI_CONTROL_MESH_COMMAND_TIME_GET, 0x0030, 0), 1);
+    TEST_CHECK_EQ(wiced_host_mesh_tx_count(HCI_CONTROL_MESH_COMMAND_TIME_GET, 0x0031, 0), 2);
+    TEST_CHECK_EQ(mesh_time_batch.in_progress, WICED_TRUE);
+
+    host_time_status(0x0031, 600000004, 0, 2, 1);
+    p_event = wiced_host_hci_event_find(HCI_CONTROL_MESH_EVENT_TIME_GET_BATCH_STATUS, 0);
+    TEST_CHECK(p_event != NULL);
+    if (p_event != NULL)
+        TEST_CHECK_EQ(p_event->data[8 + 14 + 2], 1);
+    TEST_CHECK_EQ(mesh_time_batch.num_replied, 2);
+
+    // Without replies the batch is reported when all retries have been used
+    p = param + 2;
+    UINT16_TO_STREAM(p, 0x0032);
+    UINT16_TO_STREAM(p, 0x0033);
+    host_mesh_cmd(HCI_CONTROL_MESH_COMMAND_TIME_GET_BATCH, 0, 0, param, sizeof(param));
+    wiced_host_run(MESH_TIME_BATCH_DEFAULT_TIMEOUT * 1000 - 2000);
+    TEST_CHECK_EQ(wiced_host_mesh_tx_count(HCI_CONTROL_MESH_COMMAND_TIME_GET, 0x0033, 0), 1 + MESH_TIME_REQUEST_MAX_RETRIES);
+    TEST_CHECK_EQ(mesh_time_batch.in_progress, WICED_TRUE);
+    wiced_host_run(3000);
+    TEST_CHECK_EQ(mesh_time_batch.in_progress, WICED_FALSE);
+    TEST_CHECK_EQ(wiced_host_hci_event_count(HCI_CONTROL_MESH_EVENT_TIME_GET_BATCH_STATUS, 0), 2);
+}
+
+/*
+ * Batch gets wait for a free entry of the request tracker, the reserved entries are left to
+ * the host gets
+ */
+static void test_batch_get_flow(void)
+{
+    uint8_t  param[2 + 2 * 2 * MESH_TIME_REQUEST_POOL_SIZE];
+    uint8_t *p = param;
+    uint32_t num_sent;
+    uint16_t i;
+
+    UINT8_TO_STREAM(p, 60);
+    UINT8_TO_STREAM(p, 2 * MESH_TIME_REQUEST_POOL_SIZE);
+    for (i = 0; i < 2 * MESH_TIME_REQUEST_POOL_SIZE; i++)
+        UINT16_TO_STREAM(p, 0x0100 + i);
+    host_mesh_cmd(HCI_CONTROL_MESH_COMMAND_TIME_GET_BATCH, 0, 0, param, sizeof(param));
+    wiced_host_run(2500);
+    num_sent = wiced_host_mesh_tx_count(HCI_CONTROL_MESH_COMMAND_TIME_GET, 0, 0);
+    TEST_CHECK_EQ(num_sent, MESH_TIME_REQUEST_POOL_SIZE - MESH_TIME_BATCH_RESERVED_REQUESTS);
+    TEST_CHECK_EQ(mesh_time_request.num_untracked, 0);
+
+    host_mesh_cmd(HCI_CONTROL_MESH_COMMAND_TIME_GET, 0x0002, 1, NULL, 0);
+    TEST_CHECK_EQ(wiced_host_mesh_tx_count(HCI_CONTROL_MESH_COMMAND_TIME_GET, 0x0002, 0), 1);
+
+    // Each reply lets the next get go, but the host get holds one of the reserved entries
+    for (i = 0; i < 4; i++)
+        host_time_status(0x0100 + i, 600000000, 0, 2, 1);
+    wiced_host_run(400);
+    TEST_CHECK_EQ(wiced_host_mesh_tx_count(HCI_CONTROL_MESH_COMMAND_TIME_GET, 0, 0), num_sent + 1 + 3);
+    TEST_CHECK_EQ(mesh_time_request.num_untracked, 0);
+}
+
+/*
+ * Reply to the get sets the local clock, which then moves with the local time
+ */
+static void test_clock(void)
+{
+    wiced_bt_mesh_time_state_msg_t now;
+
+    TEST_CHECK_EQ(mesh_time_client_get_time(&now), WICED_FALSE);
+
+    host_mesh_cmd(HCI_CONTROL_MESH_COMMAND_TIME_GET, 0x0002, 1, NULL, 0);
+    wiced_host_run(40);
+    host_time_status(0x0002, 600000000, 0, 2, 1);
+
+    TEST_CHECK_EQ(mesh_time_client_get_time(&now), WICED_TRUE);
+    TEST_CHECK_EQ(now.tai_seconds, 600000000);
+    TEST_CHECK_EQ(now.subsecond, (20 * 256) / 1000);
+    TEST_CHECK_EQ(now.time_authority, 1);
+    TEST_CHECK_EQ(mesh_time_clock.source, 0x0002);
+
+    wiced_host_run(1500);
+    TEST_CHECK_EQ(mesh_time_client_get_time(&now), WICED_TRUE);
+    TEST_CHECK_EQ(now.tai_seconds, 600000001);
+}
+
+/*
+ * Conversion of TAI to UTC and local time with the default TAI-UTC delta and zone
+ */
+static void test_tai_to_local(void)
+{
+    mesh_time_client_date_t utc;
+    mesh_time_client_date_t local;
+
+    mesh_time_client_tai_to_local(0, &utc, &local);
+    TEST_CHECK_EQ(utc.year, 2000);
+    TEST_CHECK_EQ(utc.month, 1);
+    TEST_CHECK_EQ(utc.day, 1);
+    TEST_CHECK_EQ(utc.hour, 0);
+    TEST_CHECK_EQ(utc.weekday, 6);
+
+    // 2024-02-29T13:45:30
+    mesh_time_client_tai_to_local(8825 * 86400ULL + 13 * 3600 + 45 * 60 + 30, &utc, NULL);
+    TEST_CHECK_EQ(utc.year, 2024);
+    TEST_CHECK_EQ(utc.month, 2);
+    TEST_CHECK_EQ(utc.day, 29);
+    TEST_CHECK_EQ(utc.hour, 13);
+    TEST_CHECK_EQ(utc.minute, 45);
+    TEST_CHECK_EQ(utc.second, 30);
+
+    // Zone of -05:00 one hour after the epoch is clamped to the epoch
+    mesh_time_conversion.zone_offset = MESH_TIME_ZONE_OFFSET_BIAS - 20;
+    mesh_time_client_tai_to_local(3600, &utc, &local);
+    TEST_CHECK_EQ(utc.year, 2000);
+    TEST_CHECK_EQ(utc.hour, 1);
+    TEST_CHECK_EQ(local.year, 2000);
+    TEST_CHECK_EQ(local.month, 1);
+    TEST_CHECK_EQ(local.day, 1);
+    TEST_CHECK_EQ(local.hour, 0);
+    TEST_CHECK_EQ(local.minute, 0);
+    TEST_CHECK_EQ(local.second, 0);
+
+    // TAI-UTC delta of 37 seconds at the epoch
+    mesh_time_conversion.zone_offset   = MESH_TIME_ZONE_OFFSET_BIAS;
+    mesh_time_conversion.tai_utc_delta = MESH_TIME_TAI_UTC_DELTA_BIAS + 37;
+    mesh_time_client_tai_to_local(10, &utc, &local);
+    TEST_CHECK_EQ(utc.year, 2000);
+    TEST_CHECK_EQ(utc.second, 0);
+    TEST_CHECK_EQ(local.second, 0);
+}
+
+/*
+ * Hours and minutes computed by the multiplication by the reciprocal are exact for every
+ * second of the day
+ */
+static void test_seconds_of_day(void)
+{
+    mesh_time_day_cache_t   cache;
+    mesh_time_client_date_t date;
+    uint32_t                sod;
+    uint32_t                num_wrong = 0;
+
+    memset(&cache, 0xFF, sizeof(cache));
+    for (sod = 0; sod < MESH_TIME_SECONDS_PER_DAY; sod++)
+    {
+        mesh_time_seconds_to_date(8825 * 86400ULL + sod, &cache, &date);
+        if ((date.hour != sod / 3600) || (date.minute != sod % 3600 / 60) || (date.second != sod % 60) || (date.day != 29))
+            num_wrong++;
+    }
+    TEST_CHECK_EQ(num_wrong, 0);
+}
+
+/*
+ * Periodic time sync polls the servers and is restored from NVRAM after the reset
+ */
+static void test_sync_scheduler(void)
+{
+    uint8_t  param[MESH_TIME_SYNC_SCHEDULER_SET_PARAM_LEN + 2];
+    uint8_t *p = param;
+
+    UINT8_TO_STREAM(p, 1);
+    UINT16_TO_STREAM(p, 10);
+    UINT16_TO_STREAM(p, 100);
+    UINT16_TO_STREAM(p, 50);
+    UINT8_TO_STREAM(p, 1);
+    UINT16_TO_STREAM(p, 0x0002);
+    host_mesh_cmd(HCI_CONTROL_MESH_COMMAND_TIME_SYNC_SCHEDULER_SET, 0, 0, param, sizeof(param));
+
+    TEST_CHECK_EQ(wiced_host.num_nvram_write, 1);
+    TEST_CHECK_EQ(wiced_host_mesh_tx_count(HCI_CONTROL_MESH_COMMAND_TIME_GET, 0x0002, 0), 1);
+    wiced_host_run(50);
+    host_time_status(0x0002, 1000, 0, 0, 1);
+    wiced_host_run(10000);
+    TEST_CHECK_EQ(wiced_host_mesh_tx_count(HCI_CONTROL_MESH_COMMAND_TIME_GET, 0x0002, 0), 2);
+    host_time_status(0x0002, 1010, 0, 0, 1);
+
+    // Reset keeps NVRAM
+    wiced_stop_timer(&mesh_time_sync.timer);
+    memset(&mesh_time_sync.config, 0, sizeof(mesh_time_sync.config));
+    mesh_app_init(WICED_TRUE);
+    TEST_CHECK_EQ(mesh_time_sync.config.num_servers, 1);
+    wiced_host_run(MESH_TIME_SYNC_RESTORE_DELAY * 1000);
+    TEST_CHECK_EQ(wiced_host_mesh_tx_count(HCI_CONTROL_MESH_COMMAND_TIME_GET, 0x0002, 0), 3);
+}
+
+/*
+ * Invalid configuration is rejected without changing the running time sync and NVRAM
+ */
+static void test_sync_scheduler_invalid(void)
+{
+    static const struct
+    {
+        uint16_t    min_interval;
+        uint16_t    max_interval;
+        uint8_t     num_servers;
+        uint32_t    length;
+    } invalid[] =
+    {
+        { 0,  100, 1, MESH_TIME_SYNC_SCHEDULER_SET_PARAM_LEN + 2 },             // min interval 0
+        { 50, 10,  1, MESH_TIME_SYNC_SCHEDULER_SET_PARAM_LEN + 2 },             // max below min
+        { 10, 100, 2, MESH_TIME_SYNC_SCHEDULER_SET_PARAM_LEN + 2 },             // truncated list
+        { 10, 100, MESH_TIME_SYNC_MAX_SERVERS + 1, MESH_TIME_SYNC_SCHEDULER_SET_PARAM_LEN + 2 * (MESH_TIME_SYNC_MAX_SERVERS + 1) },
+    };
+    const wiced_host_hci_event_t *p_event;
+    mesh_time_sync_config_t config;
+    uint8_t  param[MESH_TIME_SYNC_SCHEDULER_SET_PARAM_LEN + 2 * (MESH_TIME_SYNC_MAX_SERVERS + 1)];
+    uint8_t *p;
+    uint32_t num_events;
+    uint32_t i, j;
+
+    memset(param, 0, sizeof(param));
+    p = param;
+    UINT8_TO_STREAM(p, 1);
+    UINT16_TO_STREAM(p, 10);
+    UINT16_TO_STREAM(p, 100);
+    UINT16_TO_STREAM(p, 50);
+    UINT8_TO_STREAM(p, 1);
+    UINT16_TO_STREAM(p, 0x0002);
+    host_mesh_cmd(HCI_CONTROL_MESH_COMMAND_TIME_SYNC_SCHEDULER_SET, 0, 0, param, (uint32_t)(p - param));
+    config = mesh_time_sync.config;
+    TEST_CHECK_EQ(wiced_host.num_nvram_write, 1);
+
+    for (i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++)
+    {
+        p = param;
+        UINT8_TO_STREAM(p, 1);
+        UINT16_TO_STREAM(p, invalid[i].min_interval);
+        UINT16_TO_STREAM(p, invalid[i].max_interval);
+        UINT16_TO_STREAM(p, 50);
+        UINT8_TO_STREAM(p, invalid[i].num_servers);
+        for (j = 0; j < invalid[i].num_servers; j++)
+            UINT16_TO_STREAM(p, 0x0010 + j);
+
+        num_events = wiced_host.num_hci_events;
+        host_mesh_cmd(HCI_CONTROL_MESH_COMMAND_TIME_SYNC_SCHEDULER_SET, 0, 0, param, invalid[i].length);
+
+        TEST_CHECK(memcmp(&config, &mesh_time_sync.config, sizeof(config)) == 0);
+        TEST_CHECK(wiced_is_timer_in_use(&mesh_time_sync.timer));
+        TEST_CHECK_EQ(wiced_host.num_nvram_write, 1);
+        p_event = wiced_host_hci_event_find(HCI_CONTROL_MESH_EVENT_TIME_SYNC_SCHEDULER_STATUS, num_events);
+        TEST_CHECK(p_event != NULL);
+        if (p_event != NULL)
+            TEST_CHECK_EQ(p_event->data[p_event->length - 1], MESH_TIME_STATUS_INVALID_PARAM);
+    }
+
+    // Time sync can be stopped without the intervals
+    memset(param, 0, MESH_TIME_SYNC_SCHEDULER_SET_PARAM_LEN);
+    host_mesh_cmd(HCI_CONTROL_MESH_COMMAND_TIME_SYNC_SCHEDULER_SET, 0, 0, param, MESH_TIME_SYNC_SCHEDULER_SET_PARAM_LEN);
+    TEST_CHECK(!wiced_is_timer_in_use(&mesh_time_sync.timer));
+    TEST_CHECK_EQ(wiced_host.num_nvram_write, 2);
+    p_event = wiced_host_hci_event_find(HCI_CONTROL_MESH_EVENT_TIME_SYNC_SCHEDULER_STATUS, wiced_host.num_hci_events - 1);
+    TEST_CHECK(p_event != NULL);
+    if (p_event != NULL)
+        TEST_CHECK_EQ(p_event->data[p_event->length - 1], MESH_TIME_STATUS_SUCCESS);
+}
+
+/*
+ * Candidate with the best score becomes the Time Authority
+ */
+static void test_election(void)
+{
+    uint8_t  param[MESH_TIME_ELECTION_START_PARAM_LEN + 2 * 2];
+    uint8_t *p = param;
+
+    UINT8_TO_STREAM(p, 1);
+    UINT16_TO_STREAM(p, 0);
+    UINT16_TO_STREAM(p, 60);
+    UINT8_TO_STREAM(p, 2);
+    UINT16_TO_STREAM(p, 0x0030);
+    UINT16_TO_STREAM(p, 0x0031);
+    host_mesh_cmd(HCI_CONTROL_MESH_COMMAND_TIME_ELECTION_START, 0, 0, param, sizeof(param));
+    TEST_CHECK_EQ(mesh_time_election.state, MESH_TIME_ELECTION_STATE_SURVEY);
+
+    wiced_host_run(50);
+    host_time_status(0x0031, 600000000, 0, 1, 1);
+    host_role_status(0x0031, MESH_TIME_ROLE_NONE);
+    wiced_host_run(50);
+    host_time_status(0x0030, 600000000, 0, 10, 1);
+    host_role_status(0x0030, MESH_TIME_ROLE_AUTHORITY);
+
+    TEST_CHECK_EQ(mesh_time_election.state, MESH_TIME_ELECTION_STATE_MONITOR);
+    TEST_CHECK_EQ(mesh_time_election.authority, 0x0031);
+    TEST_CHECK_EQ(mesh_time_election.num_elected_relays, 1);
+    TEST_CHECK_EQ(mesh_time_election.relay[0], 0x0030);
+    TEST_CHECK(wiced_host_hci_event_find(HCI_CONTROL_MESH_EVENT_TIME_ELECTION_STATUS, 0) != NULL);
+
+    wiced_host_run(1000);
+    TEST_CHECK_EQ(wiced_host_mesh_tx_count(HCI_CONTROL_MESH_COMMAND_TIME_ROLE_SET, 0x0031, 0), 1);
+    TEST_CHECK_EQ(wiced_host_mesh_tx_count(HCI_CONTROL_MESH_COMMAND_TIME_ROLE_SET, 0x0030, 0), 1);
+
+    // The authority answering the monitoring gets is not missed
+    wiced_host_run(59000);
+    TEST_CHECK_EQ(wiced_host_mesh_tx_count(HCI_CONTROL_MESH_COMMAND_TIME_GET, 0x0031, 0), 2);
+    host_time_status(0x0031, 600000060, 0, 1, 1);
+    wiced_host_run(60000);
+    TEST_CHECK_EQ(mesh_time_election.num_missed, 0);
+    TEST_CHECK_EQ(mesh_time_election.state, MESH_TIME_ELECTION_STATE_MONITOR);
+
+    // The silent authority is replaced by a new election
+    wiced_host_run(MESH_TIME_ELECTION_MAX_MISSED * 60000 + MESH_TIME_ELECTION_SURVEY_TIMEOUT * 1000);
+    TEST_CHECK_EQ(mesh_time_election.num_elections, 2);
+}
+
+/*
+ * Without the monitoring the election goes idle once the roles are assigned
+ */
+static void test_election_no_monitor(void)
+{
+    uint8_t  param[MESH_TIME_ELECTION_START_PARAM_LEN + 2];
+    uint8_t *p = param;
+
+    UINT8_TO_STREAM(p, 0);
+    UINT16_TO_STREAM(p, 0);
+    UINT16_TO_STREAM(p, 0);
+    UINT8_TO_STREAM(p, 1);
+    UINT16_TO_STREAM(p, 0x0030);
+    host_mesh_cmd(HCI_CONTROL_MESH_COMMAND_TIME_ELECTION_START, 0, 0, param, sizeof(param));
+
+    wiced_host_run(50);
+    host_time_status(0x0030, 600000000, 0, 1, 1);
+    host_role_status(0x0030, MESH_TIME_ROLE_AUTHORITY);
+
+    TEST_CHECK_EQ(mesh_time_election.authority, 0x0030);
+    TEST_CHECK_EQ(mesh_time_election.state, MESH_TIME_ELECTION_STATE_IDLE);
+    wiced_host_run(600000);
+    TEST_CHECK_EQ(wiced_host_mesh_tx_count(HCI_CONTROL_MESH_COMMAND_TIME_GET, 0x0030, 0), 1);
+}
+
+/*
+ * The largest event fills the pool buffer. When the pool is empty the event is dropped and
+ * counted, the library buffers are not used.
+ */
+static void test_hci_event_pool(void)
+{
+    void *p_buf[MESH_TIME_HCI_EVENT_POOL_COUNT];
+    const wiced_host_hci_event_t *p_event;
+    int i;
+
+    host_cmd(HCI_CONTROL_MESH_COMMAND_TIME_CLIENT_STATS_GET, NULL, 0);
+    p_event = wiced_host_hci_event_find(HCI_CONTROL_MESH_EVENT_TIME_CLIENT_STATS, 0);
+    TEST_CHECK(p_event != NULL);
+    if (p_event != NULL)
+        TEST_CHECK_EQ(p_event->length, MESH_TIME_HCI_EVENT_POOL_BUF_SIZE);
+
+    for (i = 0; i < MESH_TIME_HCI_EVENT_POOL_COUNT; i++)
+        p_buf[i] = wiced_transport_allocate_buffer(mesh_time_hci_event_pool.p_pool);
+    host_time_status(0x0002, 1000, 0, 0, 0);
+    TEST_CHECK_EQ(wiced_host_hci_event_count(HCI_CONTROL_MESH_EVENT_TIME_STATUS, 0), 0);
+    TEST_CHECK_EQ(mesh_time_hci_event_pool.num_alloc_fail, 1);
+    TEST_CHECK_EQ(wiced_host.num_hci_events_lib, 0);
+    for (i = 0; i < MESH_TIME_HCI_EVENT_POOL_COUNT; i++)
+        wiced_transport_free_buffer(p_buf[i]);
+}
+
+/*
+ * Trace records are drained to the host after the message processing
+ */
+static void test_trace_drain(void)
+{
+    const wiced_host_hci_event_t *p_event;
+
+    MESH_TIME_TRACE(ERROR, BAD_LEN, 0x1234, 1, 2);
+    TEST_CHECK_EQ(wiced_host_hci_event_count(HCI_CONTROL_MESH_EVENT_TIME_CLIENT_TRACE, 0), 0);
+
+    wiced_host_run(MESH_TIME_TRACE_DRAIN_DELAY);
+    p_event = wiced_host_hci_event_find(HCI_CONTROL_MESH_EVENT_TIME_CLIENT_TRACE, 0);
+    TEST_CHECK(p_event != NULL);
+    if (p_event != NULL)
+    {
+        TEST_CHECK(p_event->data[5] >= 1);
+        TEST_CHECK_EQ(p_event->data[8 + 4], MESH_TIME_TRACE_ID_BAD_LEN);
+        TEST_CHECK_EQ(host_le32(p_event->data + 8 + 6), 0x1234);
+    }
+}
+
+#if LOW_POWER_NODE
+/*
+ * Gets deferred to the friend poll are sent together
+ */
+static void test_lpn_defer(void)
+{
+    uint8_t enable = 1;
+
+    host_cmd(HCI_CONTROL_MESH_COMMAND_TIME_LPN_SET, &enable, 1);
+    host_mesh_cmd(HCI_CONTROL_MESH_COMMAND_TIME_GET, 0x0002, 1, NULL, 0);
+    host_mesh_cmd(HCI_CONTROL_MESH_COMMAND_TIME_ZONE_GET, 0x0003, 1, NULL, 0);
+    TEST_CHECK_EQ(wiced_host.num_mesh_tx, 0);
+    TEST_CHECK_EQ(mesh_time_lpn.depth, 2);
+
+    wiced_host_run(MESH_TIME_LPN_MAX_DEFER);
+    TEST_CHECK_EQ(wiced_host.num_mesh_tx, 2);
+    TEST_CHECK_EQ(mesh_time_lpn.num_tx_wakeups, 1);
+}
+
+/*
+ * Deferral is off by default. Deferred gets are sent when the core goes to sleep, the device
+ * enters HID-Off only when nothing is deferred.
+ */
+static void test_lpn_sleep(void)
+{
+    uint8_t enable = 1;
+
+    TEST_CHECK_EQ(mesh_time_lpn.enabled, WICED_FALSE);
+    host_mesh_cmd(HCI_CONTROL_MESH_COMMAND_TIME_GET, 0x0002, 1, NULL, 0);
+    TEST_CHECK_EQ(wiced_host.num_mesh_tx, 1);
+
+    host_cmd(HCI_CONTROL_MESH_COMMAND_TIME_LPN_SET, &enable, 1);
+    host_mesh_cmd(HCI_CONTROL_MESH_COMMAND_TIME_ZONE_GET, 0x0003, 1, NULL, 0);
+    TEST_CHECK_EQ(wiced_host.num_mesh_tx, 1);
+
+    wiced_bt_mesh_app_func_table.p_mesh_app_lpn_sleep(5000);
+    TEST_CHECK_EQ(wiced_host.num_mesh_tx, 2);
+    TEST_CHECK_EQ(wiced_host.num_hid_off, 0);
+
+    wiced_bt_mesh_app_func_table.p_mesh_app_lpn_sleep(5000);
+    TEST_CHECK_EQ(wiced_host.num_hid_off, 1);
+    TEST_CHECK_EQ(wiced_host.last_hid_off_ms, 5000);
+}
+#else
+/*
+ * Friend sends the time update before the predicted poll of the Low Power Node
+ */
+static void test_proxy_update(void)
+{
+    uint8_t  param[MESH_TIME_PROXY_SET_PARAM_LEN + 6];
+    uint8_t *p = param;
+
+    // The friend knows the time
+    host_mesh_cmd(HCI_CONTROL_MESH_COMMAND_TIME_GET, 0x0002, 1, NULL, 0);
+    wiced_host_run(40);
+    host_time_status(0x0002, 600000000, 0, 2, 1);
+
+    UINT8_TO_STREAM(p, 0);
+    UINT16_TO_STREAM(p, 0);
+    UINT16_TO_STREAM(p, 1);
+    UINT8_TO_STREAM(p, 1);
+    UINT16_TO_STREAM(p, 0x0040);
+    UINT16_TO_STREAM(p, 50);        // 5 seconds
+    UINT16_TO_STREAM(p, 1000);
+    host_cmd(HCI_CONTROL_MESH_COMMAND_TIME_PROXY_SET, param, sizeof(param));
+
+    wiced_host_run(1000);
+    TEST_CHECK_EQ(wiced_host_mesh_tx_count(HCI_CONTROL_MESH_COMMAND_TIME_SET, 0x0040, 0), 1);
+    wiced_host_run(5000);
+    TEST_CHECK_EQ(wiced_host_mesh_tx_count(HCI_CONTROL_MESH_COMMAND_TIME_SET, 0x0040, 0), 2);
+    TEST_CHECK_EQ(wiced_host_mesh_tx_get(wiced_host.num_mesh_tx - 1)->param.time.time_authority, 0);
+}
+
+/*
+ * Time Status which is not a reply sets the clock only if it comes from a configured server,
+ * never from a Low Power Node receiving the time updates
+ */
+static void test_proxy_unsolicited(void)
+{
+    uint8_t  param[MESH_TIME_PROXY_SET_PARAM_LEN + 6];
+    uint8_t *p = param;
+
+    UINT8_TO_STREAM(p, 0);
+    UINT16_TO_STREAM(p, 0);
+    UINT16_TO_STREAM(p, 1);
+    UINT8_TO_STREAM(p, 1);
+    UINT16_TO_STREAM(p, 0x0040);
+    UINT16_TO_STREAM(p, 50);
+    UINT16_TO_STREAM(p, 1000);
+    host_cmd(HCI_CONTROL_MESH_COMMAND_TIME_PROXY_SET, param, sizeof(param));
+
+    host_time_status(0x0040, 600000000, 0, 2, 0);
+    host_time_status(0x0005, 600000000, 0, 2, 1);
+    TEST_CHECK_EQ(mesh_time_clock.valid, WICED_FALSE);
+
+    // Server configured for the time sync, the sync itself is not running
+    mesh_time_sync.config.num_servers = 1;
+    mesh_time_sync.config.server[0]   = 0x0005;
+    host_time_status(0x0005, 600000000, 0, 2, 1);
+    TEST_CHECK_EQ(mesh_time_clock.valid, WICED_TRUE);
+    TEST_CHECK_EQ(mesh_time_clock.source, 0x0005);
+}
+#endif
+
+static const test_case_t test_cases[] =
+{
+    { "command_find",           test_command_find },
+    { "time_get",               test_time_get },
+    { "time_get_coalesced",     test_time_get_coalesced },
+    { "time_get_timeout",       test_time_get_timeout },
+    { "server_table",           test_server_table },
+    { "command_length",         test_command_length },
+    { "pacing",                 test_pacing },
+    { "command_batch",          test_command_batch },
+    { "batch_get",              test_batch_get },
+    { "batch_get_retry",        test_batch_get_retry },
+    { "batch_get_flow",         test_batch_get_flow },
+    { "clock",                  test_clock },
+    { "tai_to_local",           test_tai_to_local },
+    { "seconds_of_day",         test_seconds_of_day },
+    { "sync_scheduler",         test_sync_scheduler },
+    { "sync_scheduler_invalid", test_sync_scheduler_invalid },
+    { "election",               test_election },
+    { "election_no_monitor",    test_election_no_monitor },
+    { "hci_event_pool",         test_hci_event_pool },
+    { "trace_drain",            test_trace_drain },
+#if LOW_POWER_NODE
+    { "lpn_defer",              test_lpn_defer },
+    { "lpn_sleep",              test_lpn_sleep },
+#else
+    { "proxy_update",           test_proxy_update },
+    { "proxy_unsolicited",      test_proxy_unsolicited },
+#endif
+};
+
+/*
+ * Run the test in a child process. Mesh events and HCI event buffers shall be released when
+ * the test is over.
+ */
+static int test_run(const test_case_t *p_case)
+{
+    pid_t pid;
+    int   status;
+
+    fflush(stdout);
+    if ((pid = fork()) == 0)
+    {
+        wiced_host_reset(1);
+        mesh_app_init(WICED_TRUE);
+        p_case->p_test();
+        TEST_CHECK_EQ(wiced_host.num_events_in_use, 0);
+        TEST_CHECK_EQ(wiced_host.num_hci_events_in_use, 0);
+        fflush(stdout);
+        _exit(test_failed);
+    }
+    if ((pid < 0) || (waitpid(pid, &status, 0) != pid))
+        return 1;
+    if (WIFSIGNALED(status))
+        printf("  terminated by signal %d\n", WTERMSIG(status));
+    return !WIFEXITED(status) || (WEXITSTATUS(status) != 0);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t num_run = 0;
+    uint32_t num_failed = 0;
+    uint32_t i;
+    int      j;
+
+    for (i = 0; i < sizeof(test_cases) / sizeof(test_cases[0]); i++)
+    {
+        for (j = 1; (j < argc) && (strstr(test_cases[i].name, argv[j]) == NULL); j++)
+            ;
+        if ((argc > 1) && (j == argc))
+            continue;
+
+        num_run++;
+        if (test_run(&test_cases[i]))
+        {
+            printf("FAIL %s\n", test_cases[i].name);
+            num_failed++;
+        }
+        else
+        {
+            printf("ok   %s\n", test_cases[i].name);
+        }
+    }
+    printf("%s: %u tests, %u failed\n", MESH_TIME_HOST_CONFIG, num_run, num_failed);
+    return (num_failed != 0) ? 1 : 0;
+}
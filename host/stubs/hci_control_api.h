@@ -0,0 +1,5 @@
+/* Host build stand-in for the SDK header, see wiced_host.h */
+#ifndef HCI_CONTROL_API_H
+#define HCI_CONTROL_API_H
+#include "wiced_host.h"
+#endif
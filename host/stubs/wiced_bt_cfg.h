@@ -0,0 +1,5 @@
+/* Host build stand-in for the SDK header, see wiced_host.h */
+#ifndef WICED_BT_CFG_H
+#define WICED_BT_CFG_H
+#include "wiced_host.h"
+#endif
@@ -0,0 +1,5 @@
+/* Host build stand-in for the SDK header, see wiced_host.h */
+#ifndef WICED_HAL_NVRAM_H
+#define WICED_HAL_NVRAM_H
+#include "wiced_host.h"
+#endif
@@ -0,0 +1,458 @@
+/*
+* Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*/
+
+/** @file
+ *
+ * Stand-ins for the WICED BT SDK interfaces used by the mesh time client, so that
+ * mesh_time_client.c can be built and exercised on the host. Only the types, constants and
+ * functions used by the application are provided. The SDK header names in this directory
+ * include this file.
+ *
+ * The host side of the stubs simulates the local clock and the timers, keeps NVRAM in RAM,
+ * records the mesh messages sent by the application and the HCI events sent to the host, and
+ * delivers received statuses to the callback registered by the application. Nothing is sent
+ * over a radio or a UART.
+ */
+#ifndef WICED_HOST_H
+#define WICED_HOST_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************
+ *          Basic types
+ ******************************************************/
+typedef unsigned int wiced_bool_t;
+
+#define WICED_TRUE      1
+#define WICED_FALSE     0
+
+typedef enum
+{
+    WICED_SUCCESS       = 0,
+    WICED_ERROR         = 1,
+    WICED_BADARG        = 5,
+    WICED_NO_MEMORY     = 0x1B,
+} wiced_result_t;
+
+#define STREAM_TO_UINT8(u8, p)   {u8 = (uint8_t)(*(p)); (p) += 1;}
+#define STREAM_TO_UINT16(u16, p) {u16 = ((uint16_t)(*(p)) + (((uint16_t)(*((p) + 1))) << 8)); (p) += 2;}
+#define STREAM_TO_UINT32(u32, p) {u32 = (((uint32_t)(*(p))) + ((((uint32_t)(*((p) + 1)))) << 8) + ((((uint32_t)(*((p) + 2)))) << 16) + ((((uint32_t)(*((p) + 3)))) << 24)); (p) += 4;}
+#define STREAM_TO_UINT40(u40, p) {u40 = (((uint64_t)(*(p))) + ((((uint64_t)(*((p) + 1)))) << 8) + ((((uint64_t)(*((p) + 2)))) << 16) + ((((uint64_t)(*((p) + 3)))) << 24) + ((((uint64_t)(*((p) + 4)))) << 32)); (p) += 5;}
+#define UINT8_TO_STREAM(p, u8)   {*(p)++ = (uint8_t)(u8);}
+#define UINT16_TO_STREAM(p, u16) {*(p)++ = (uint8_t)(u16); *(p)++ = (uint8_t)((u16) >> 8);}
+#define UINT32_TO_STREAM(p, u32) {*(p)++ = (uint8_t)(u32); *(p)++ = (uint8_t)((u32) >> 8); *(p)++ = (uint8_t)((u32) >> 16); *(p)++ = (uint8_t)((u32) >> 24);}
+#define UINT40_TO_STREAM(p, u40) {*(p)++ = (uint8_t)(u40); *(p)++ = (uint8_t)((u40) >> 8); *(p)++ = (uint8_t)((u40) >> 16); *(p)++ = (uint8_t)((u40) >> 24); *(p)++ = (uint8_t)((u40) >> 32);}
+
+/******************************************************
+ *          wiced_bt_trace.h
+ ******************************************************/
+void wiced_bt_trace(const char *p_format, ...) __attribute__((format(printf, 1, 2)));
+
+#ifdef WICED_BT_TRACE_ENABLE
+#define WICED_BT_TRACE(...)     wiced_bt_trace(__VA_ARGS__)
+#else
+#define WICED_BT_TRACE(...)
+#endif
+
+/******************************************************
+ *          wiced_timer.h
+ ******************************************************/
+#define TIMER_PARAM_TYPE        uint32_t
+
+typedef void (*wiced_timer_callback_t)(TIMER_PARAM_TYPE cb_params);
+
+typedef enum
+{
+    WICED_SECONDS_TIMER = 1,
+    WICED_MILLI_SECONDS_TIMER,
+    WICED_SECONDS_PERIODIC_TIMER,
+    WICED_MILLI_SECONDS_PERIODIC_TIMER,
+} wiced_timer_type_t;
+
+typedef struct wiced_timer_s
+{
+    wiced_timer_callback_t  p_cback;
+    TIMER_PARAM_TYPE        arg;
+    wiced_timer_type_t      type;
+    uint32_t                timeout;            // Timeout in the units of the timer type
+    uint64_t                deadline_ms;        // Simulated tick at which the timer expires
+    wiced_bool_t            in_use;
+    struct wiced_timer_s   *p_next;             // All initialized timers, for the simulation
+} wiced_timer_t;
+
+wiced_result_t wiced_init_timer(wiced_timer_t *p_timer, wiced_timer_callback_t p_cb, TIMER_PARAM_TYPE cb_param, wiced_timer_type_t timer_type);
+wiced_result_t wiced_start_timer(wiced_timer_t *p_timer, uint32_t timeout);
+wiced_result_t wiced_stop_timer(wiced_timer_t *p_timer);
+wiced_bool_t   wiced_is_timer_in_use(wiced_timer_t *p_timer);
+
+/******************************************************
+ *          wiced_hal_rand.h, wiced_hal_nvram.h, wiced_sleep.h
+ ******************************************************/
+uint32_t wiced_hal_rand_gen_num(void);
+
+#define WICED_NVRAM_VSID_START  0x200
+#define WICED_NVRAM_VSID_END    0x3FFF
+
+uint16_t wiced_hal_write_nvram(uint16_t vs_id, uint16_t data_length, uint8_t *p_data, wiced_result_t *p_status);
+uint16_t wiced_hal_read_nvram(uint16_t vs_id, uint16_t data_length, uint8_t *p_data, wiced_result_t *p_status);
+
+wiced_result_t wiced_sleep_enter_hid_off(uint32_t wakeup_time, uint32_t wakeup_pin, uint32_t wakeup_level);
+
+/******************************************************
+ *          wiced_transport.h
+ ******************************************************/
+typedef struct wiced_transport_buffer_pool_s wiced_transport_buffer_pool_t;
+
+wiced_transport_buffer_pool_t *wiced_transport_create_buffer_pool(uint32_t buffer_size, uint32_t buffer_count);
+void    *wiced_transport_allocate_buffer(wiced_transport_buffer_pool_t *p_pool);
+uint32_t wiced_transport_get_buffer_count(wiced_transport_buffer_pool_t *p_pool);
+void     wiced_transport_free_buffer(void *p_buf);
+
+/******************************************************
+ *          wiced_bt_ble.h, wiced_bt_gatt.h, wiced_bt_cfg.h
+ ******************************************************/
+#define BTM_BLE_ADVERT_TYPE_NAME_COMPLETE   0x09
+#define BTM_BLE_ADVERT_TYPE_APPEARANCE      0x19
+#define APPEARANCE_GENERIC_TAG              512
+
+typedef struct
+{
+    uint8_t     advert_type;
+    uint16_t    len;
+    uint8_t    *p_data;
+} wiced_bt_ble_advert_elem_t;
+
+typedef struct
+{
+    uint8_t    *device_name;
+    struct
+    {
+        uint16_t appearance;
+    } gatt_cfg;
+} wiced_bt_cfg_settings_t;
+
+/******************************************************
+ *          wiced_bt_mesh_core.h
+ ******************************************************/
+#define MESH_COMPANY_ID_BT_SIG                      0x0000
+#define MESH_COMPANY_ID_CYPRESS                     0x0131
+#define WICED_BT_MESH_CORE_MODEL_ID_TIME_CLNT       0x1202
+
+#define WICED_BT_MESH_CORE_FEATURE_BIT_RELAY        0x01
+#define WICED_BT_MESH_CORE_FEATURE_BIT_GATT_PROXY_SERVER 0x02
+#define WICED_BT_MESH_CORE_FEATURE_BIT_FRIEND       0x04
+#define WICED_BT_MESH_CORE_FEATURE_BIT_LOW_POWER    0x08
+
+#define MESH_ELEM_LOC_MAIN                          0x0100
+#define MESH_DEFAULT_TRANSITION_TIME_IN_MS          0
+#define WICED_BT_MESH_ON_POWER_UP_STATE_RESTORE     2
+
+#define WICED_BT_MESH_PROPERTY_LEN_DEVICE_MANUFACTURER_NAME 36
+#define WICED_BT_MESH_PROPERTY_LEN_DEVICE_MODEL_NUMBER      24
+
+typedef struct
+{
+    uint16_t    company_id;
+    uint16_t    model_id;
+} wiced_bt_mesh_core_config_model_t;
+
+#define WICED_BT_MESH_DEVICE                { MESH_COMPANY_ID_BT_SIG, 0x0000 }
+#define WICED_BT_MESH_MODEL_TIME_CLIENT     { MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_TIME_CLNT }
+
+typedef struct
+{
+    uint16_t    location;
+    uint32_t    default_transition_time;
+    uint8_t     onpowerup_state;
+    uint8_t     properties_num;
+    void       *properties;
+    uint8_t     models_num;
+    wiced_bt_mesh_core_config_model_t *models;
+} wiced_bt_mesh_core_config_element_t;
+
+typedef struct
+{
+    uint16_t    receive_window;
+    uint16_t    cache_buf_len;
+    uint16_t    max_lpn_num;
+} wiced_bt_mesh_core_config_friend_t;
+
+typedef struct
+{
+    uint8_t     rssi_factor;
+    uint8_t     receive_window_factor;
+    uint8_t     min_cache_size_log;
+    uint8_t     receive_delay;
+    uint32_t    poll_timeout;
+} wiced_bt_mesh_core_config_low_power_t;
+
+typedef struct
+{
+    uint16_t    company_id;
+    uint16_t    product_id;
+    uint16_t    vendor_id;
+    uint16_t    features;
+    wiced_bt_mesh_core_config_friend_t      friend_cfg;
+    wiced_bt_mesh_core_config_low_power_t   low_power;
+    wiced_bool_t gatt_client_only;
+    uint8_t     elements_num;
+    wiced_bt_mesh_core_config_element_t    *elements;
+} wiced_bt_mesh_core_config_t;
+
+uint64_t wiced_bt_mesh_core_get_tick_count(void);
+
+/******************************************************
+ *          wiced_bt_mesh_models.h
+ ******************************************************/
+typedef struct
+{
+    uint16_t    opcode;
+    uint16_t    company_id;
+    uint16_t    model_id;
+    uint8_t     ttl;
+    uint8_t     element_idx;
+    uint16_t    src;
+    uint16_t    dst;
+    uint16_t    app_key_idx;
+    uint8_t     reply;
+    uint8_t     send_segmented;
+    uint8_t     retrans_time;
+    uint8_t     retrans_cnt;
+    uint16_t    reply_timeout;
+    uint16_t    data_len;
+} wiced_bt_mesh_event_t;
+
+typedef struct __attribute__((packed))
+{
+    uint16_t    src;
+    uint16_t    app_key_idx;
+    uint8_t     element_idx;
+    uint8_t     data[1];
+} wiced_bt_mesh_hci_event_t;
+
+typedef struct
+{
+    uint64_t    tai_seconds;
+    uint8_t     subsecond;
+    uint8_t     uncertainty;
+    uint8_t     time_authority;
+    uint16_t    tai_utc_delta_current;
+    uint8_t     time_zone_offset_current;
+} wiced_bt_mesh_time_state_msg_t;
+
+typedef struct
+{
+    uint8_t     time_zone_offset_current;
+    uint8_t     time_zone_offset_new;
+    uint64_t    tai_of_zone_change;
+} wiced_bt_mesh_time_zone_status_t;
+
+typedef struct
+{
+    uint8_t     time_zone_offset_new;
+    uint64_t    tai_of_zone_change;
+} wiced_bt_mesh_time_zone_set_t;
+
+typedef struct
+{
+    uint16_t    tai_utc_delta_current;
+    uint16_t    tai_utc_delta_new;
+    uint64_t    tai_of_delta_change;
+} wiced_bt_mesh_time_tai_utc_delta_status_t;
+
+typedef struct
+{
+    uint16_t    tai_utc_delta_new;
+    uint64_t    tai_of_delta_change;
+} wiced_bt_mesh_time_tai_utc_delta_set_t;
+
+typedef struct
+{
+    uint8_t     role;
+} wiced_bt_mesh_time_role_msg_t;
+
+#define WICED_BT_MESH_TIME_STATUS           0x50
+#define WICED_BT_MESH_TIME_ZONE_STATUS      0x51
+#define WICED_BT_MESH_TAI_UTC_DELTA_STATUS  0x52
+#define WICED_BT_MESH_TIME_ROLE_STATUS      0x53
+
+typedef void (wiced_bt_mesh_time_client_callback_t)(uint16_t event, wiced_bt_mesh_event_t *p_event, void *p_data);
+
+void           wiced_bt_mesh_model_time_client_init(wiced_bt_mesh_time_client_callback_t *p_callback, wiced_bool_t is_provisioned);
+wiced_result_t wiced_bt_mesh_model_time_client_time_get_send(wiced_bt_mesh_event_t *p_event);
+wiced_result_t wiced_bt_mesh_model_time_client_time_set_send(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_time_state_msg_t *p_data);
+wiced_result_t wiced_bt_mesh_model_time_client_time_zone_get_send(wiced_bt_mesh_event_t *p_event);
+wiced_result_t wiced_bt_mesh_model_time_client_time_zone_set_send(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_time_zone_set_t *p_data);
+wiced_result_t wiced_bt_mesh_model_time_client_tai_utc_delta_get_send(wiced_bt_mesh_event_t *p_event);
+wiced_result_t wiced_bt_mesh_model_time_client_tai_utc_delta_set_send(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_time_tai_utc_delta_set_t *p_data);
+wiced_result_t wiced_bt_mesh_model_time_client_time_role_get_send(wiced_bt_mesh_event_t *p_event);
+wiced_result_t wiced_bt_mesh_model_time_client_time_role_set_send(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_time_role_msg_t *p_data);
+
+/******************************************************
+ *          wiced_bt_mesh_app.h
+ ******************************************************/
+typedef void     (*wiced_bt_mesh_app_init_t)(wiced_bool_t is_provisioned);
+typedef void     (*wiced_bt_mesh_app_hardware_init_t)(void);
+typedef void     (*wiced_bt_mesh_app_connect_status_t)(uint8_t is_connected, uint32_t conn_id, uint16_t mtu);
+typedef void     (*wiced_bt_mesh_app_attention_t)(uint8_t element_idx, uint8_t dur);
+typedef void     (*wiced_bt_mesh_app_notify_period_set_t)(uint8_t element_idx, uint16_t company_id, uint16_t model_id, uint32_t period);
+typedef uint32_t (*wiced_bt_mesh_app_proc_rx_cmd_t)(uint16_t opcode, uint8_t *p_data, uint32_t length);
+typedef void     (*wiced_bt_mesh_app_lpn_sleep_t)(uint32_t max_sleep_duration);
+typedef void     (*wiced_bt_mesh_app_factory_reset_t)(void);
+
+typedef struct
+{
+    wiced_bt_mesh_app_init_t                p_mesh_app_init;
+    wiced_bt_mesh_app_hardware_init_t       p_mesh_app_hw_init;
+    wiced_bt_mesh_app_connect_status_t      p_mesh_app_gatt_conn_status;
+    wiced_bt_mesh_app_attention_t           p_mesh_app_attention;
+    wiced_bt_mesh_app_notify_period_set_t   p_mesh_app_notify_period_set;
+    wiced_bt_mesh_app_proc_rx_cmd_t         p_mesh_app_proc_rx_cmd;
+    wiced_bt_mesh_app_lpn_sleep_t           p_mesh_app_lpn_sleep;
+    wiced_bt_mesh_app_factory_reset_t       p_mesh_app_factory_reset;
+} wiced_bt_mesh_app_func_table_t;
+
+wiced_bt_mesh_event_t     *wiced_bt_mesh_create_event(uint8_t element_idx, uint16_t company_id, uint16_t model_id, uint16_t dst, uint16_t app_key_idx);
+wiced_bt_mesh_event_t     *wiced_bt_mesh_create_event_from_wiced_hci(uint16_t opcode, uint16_t company_id, uint16_t model_id, uint8_t **p_data, uint32_t *len);
+void                       wiced_bt_mesh_release_event(wiced_bt_mesh_event_t *p_event);
+wiced_bt_mesh_hci_event_t *wiced_bt_mesh_create_hci_event(wiced_bt_mesh_event_t *p_event);
+wiced_result_t             mesh_transport_send_data(uint16_t opcode, uint8_t *p_data, uint16_t length);
+void                       wiced_bt_mesh_set_raw_scan_response_data(uint8_t num_elem, wiced_bt_ble_advert_elem_t *p_adv);
+
+/******************************************************
+ *          hci_control_api.h
+ ******************************************************/
+#define HCI_CONTROL_GROUP_MESH                              0x16
+
+#define HCI_CONTROL_MESH_COMMAND_TIME_GET                   ((HCI_CONTROL_GROUP_MESH << 8) | 0x80)
+#define HCI_CONTROL_MESH_COMMAND_TIME_SET                   ((HCI_CONTROL_GROUP_MESH << 8) | 0x81)
+#define HCI_CONTROL_MESH_COMMAND_TIME_ZONE_GET              ((HCI_CONTROL_GROUP_MESH << 8) | 0x82)
+#define HCI_CONTROL_MESH_COMMAND_TIME_ZONE_SET              ((HCI_CONTROL_GROUP_MESH << 8) | 0x83)
+#define HCI_CONTROL_MESH_COMMAND_TIME_TAI_UTC_DELTA_GET     ((HCI_CONTROL_GROUP_MESH << 8) | 0x84)
+#define HCI_CONTROL_MESH_COMMAND_TIME_TAI_UTC_DELTA_SET     ((HCI_CONTROL_GROUP_MESH << 8) | 0x85)
+#define HCI_CONTROL_MESH_COMMAND_TIME_ROLE_GET              ((HCI_CONTROL_GROUP_MESH << 8) | 0x86)
+#define HCI_CONTROL_MESH_COMMAND_TIME_ROLE_SET              ((HCI_CONTROL_GROUP_MESH << 8) | 0x87)
+
+#define HCI_CONTROL_MESH_EVENT_TIME_STATUS                  ((HCI_CONTROL_GROUP_MESH << 8) | 0x80)
+#define HCI_CONTROL_MESH_EVENT_TIME_ZONE_STATUS             ((HCI_CONTROL_GROUP_MESH << 8) | 0x81)
+#define HCI_CONTROL_MESH_EVENT_TIME_TAI_UTC_DELTA_STATUS    ((HCI_CONTROL_GROUP_MESH << 8) | 0x82)
+#define HCI_CONTROL_MESH_EVENT_TIME_ROLE_STATUS             ((HCI_CONTROL_GROUP_MESH << 8) | 0x83)
+
+/******************************************************
+ *          Host simulation
+ ******************************************************/
+#define WICED_HOST_MESH_HDR_LEN         11      // Mesh header of the HCI commands, see wiced_host_mesh_hdr()
+#define WICED_HOST_HCI_EVENT_MAX_LEN    1024    // Max length of the recorded HCI event
+#define WICED_HOST_LOG_SIZE             256     // Number of the last messages and events kept in the logs, power of 2
+
+// Mesh message sent by the application through the time client model
+typedef struct
+{
+    uint16_t    opcode;                 // HCI_CONTROL_MESH_COMMAND_TIME_xxx of the message
+    uint16_t    dst;
+    uint16_t    app_key_idx;
+    uint8_t     element_idx;
+    uint8_t     ttl;
+    uint8_t     reply;
+    uint64_t    tick_ms;                // Simulated time of the send
+    union
+    {
+        wiced_bt_mesh_time_state_msg_t          time;
+        wiced_bt_mesh_time_zone_set_t           zone;
+        wiced_bt_mesh_time_tai_utc_delta_set_t  delta;
+        wiced_bt_mesh_time_role_msg_t           role;
+    } param;
+} wiced_host_mesh_msg_t;
+
+// HCI event sent by the application to the host
+typedef struct
+{
+    uint16_t    opcode;
+    uint16_t    length;
+    uint64_t    tick_ms;
+    uint8_t     data[WICED_HOST_HCI_EVENT_MAX_LEN];
+} wiced_host_hci_event_t;
+
+typedef void (*wiced_host_mesh_tx_cback_t)(const wiced_host_mesh_msg_t *p_msg);
+typedef void (*wiced_host_hci_event_cback_t)(uint16_t opcode, const uint8_t *p_data, uint16_t length);
+
+typedef struct
+{
+    uint64_t    tick_ms;                // Simulated local clock
+
+    uint32_t    num_mesh_tx;            // Mesh messages sent by the application
+    uint32_t    num_hci_events;         // HCI events sent to the host
+    uint32_t    num_events_in_use;      // Mesh events created and not released, to detect the leaks
+    uint32_t    num_hci_events_lib;     // HCI events allocated from the library buffers
+    uint32_t    num_hci_events_in_use;  // HCI event buffers allocated and not sent
+    uint32_t    num_nvram_write;
+    uint32_t    num_hid_off;            // Calls to the default sleep of the Low Power Node
+    uint32_t    last_hid_off_ms;        // Duration of the last sleep
+    wiced_bool_t fail_event_alloc;      // Make wiced_bt_mesh_create_event and the HCI header parsing fail
+    wiced_bool_t fail_hci_event_alloc;  // Make the library HCI event allocation fail
+    wiced_bool_t log_disabled;          // Do not copy the messages and events to the logs
+    wiced_bool_t trace_enabled;         // Print WICED_BT_TRACE output
+
+    wiced_host_mesh_tx_cback_t      p_mesh_tx_cback;    // Called for each sent mesh message
+    wiced_host_hci_event_cback_t    p_hci_event_cback;  // Called for each HCI event
+
+    wiced_host_mesh_msg_t   mesh_tx[WICED_HOST_LOG_SIZE];
+    wiced_host_hci_event_t  hci_event[WICED_HOST_LOG_SIZE];
+} wiced_host_t;
+
+extern wiced_host_t wiced_host;
+
+void     wiced_host_reset(uint32_t seed);
+void     wiced_host_seed(uint32_t seed);
+wiced_bool_t wiced_host_run_next(uint64_t until_ms);
+void     wiced_host_run_until(uint64_t until_ms);
+void     wiced_host_run(uint32_t duration_ms);
+uint8_t *wiced_host_mesh_hdr(uint8_t *p, uint16_t dst, uint16_t app_key_idx, uint8_t reply);
+void     wiced_host_status_deliver(uint16_t event, uint16_t src, uint16_t dst, void *p_data);
+const wiced_host_mesh_msg_t  *wiced_host_mesh_tx_get(uint32_t idx);
+const wiced_host_hci_event_t *wiced_host_hci_event_get(uint32_t idx);
+const wiced_host_hci_event_t *wiced_host_hci_event_find(uint16_t opcode, uint32_t from);
+uint32_t wiced_host_hci_event_count(uint16_t opcode, uint32_t from);
+uint32_t wiced_host_mesh_tx_count(uint16_t opcode, uint16_t dst, uint32_t from);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WICED_HOST_H */
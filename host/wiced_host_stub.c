@@ -0,0 +1,639 @@
+/*
+* Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*/
+
+/** @file
+ *
+ * Host implementation of the SDK stand-ins declared in stubs/wiced_host.h. Time is simulated:
+ * the local clock only moves when the driver runs the timers, so the runs are reproducible and
+ * faster than real time.
+ */
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "wiced_host.h"
+
+/******************************************************
+ *          Constants
+ ******************************************************/
+#define WICED_HOST_NVRAM_MAX_ITEMS      8
+#define WICED_HOST_NVRAM_MAX_LEN        256
+#define WICED_HOST_START_TICK_MS        1000    // The application treats tick 0 as not set
+
+/******************************************************
+ *          Structures
+ ******************************************************/
+// Header of the transport buffers, the data follows
+typedef struct wiced_host_buffer_s
+{
+    wiced_transport_buffer_pool_t  *p_pool;     // NULL if allocated for the library
+    struct wiced_host_buffer_s     *p_next;     // Next free buffer of the pool
+    uint64_t                        align;
+} wiced_host_buffer_t;
+
+struct wiced_transport_buffer_pool_s
+{
+    uint32_t                buffer_size;
+    uint32_t                buffer_count;
+    uint32_t                num_free;
+    wiced_host_buffer_t    *p_free;
+};
+
+typedef struct
+{
+    uint16_t    vs_id;
+    uint16_t    length;
+    uint8_t     data[WICED_HOST_NVRAM_MAX_LEN];
+} wiced_host_nvram_item_t;
+
+/******************************************************
+ *          Variables Definitions
+ ******************************************************/
+wiced_host_t wiced_host = { .tick_ms = WICED_HOST_START_TICK_MS };
+
+wiced_bt_cfg_settings_t wiced_bt_cfg_settings;
+
+static wiced_timer_t *wiced_host_timers;
+static wiced_bt_mesh_time_client_callback_t *wiced_host_time_client_cback;
+static wiced_host_nvram_item_t wiced_host_nvram[WICED_HOST_NVRAM_MAX_ITEMS];
+static uint32_t wiced_host_rand_state = 1;
+
+/******************************************************
+ *          Host simulation
+ ******************************************************/
+
+/*
+ * Clear the counters, the logs and NVRAM and stop all timers. The local clock is restarted.
+ */
+void wiced_host_reset(uint32_t seed)
+{
+    wiced_timer_t *p_timer;
+
+    memset(&wiced_host, 0, sizeof(wiced_host));
+    memset(wiced_host_nvram, 0, sizeof(wiced_host_nvram));
+    wiced_host.tick_ms = WICED_HOST_START_TICK_MS;
+
+    for (p_timer = wiced_host_timers; p_timer != NULL; p_timer = p_timer->p_next)
+        p_timer->in_use = WICED_FALSE;
+
+    wiced_host_seed(seed);
+}
+
+/*
+ * Seed the random numbers returned by wiced_hal_rand_gen_num
+ */
+void wiced_host_seed(uint32_t seed)
+{
+    wiced_host_rand_state = (seed != 0) ? seed : 1;
+}
+
+/*
+ * Run the timer with the earliest deadline if it expires not later than until_ms. The local
+ * clock is moved to the deadline. Returns WICED_FALSE if no timer expires until then.
+ */
+wiced_bool_t wiced_host_run_next(uint64_t until_ms)
+{
+    wiced_timer_t *p_timer;
+    wiced_timer_t *p_next = NULL;
+
+    for (p_timer = wiced_host_timers; p_timer != NULL; p_timer = p_timer->p_next)
+    {
+        if (p_timer->in_use && ((p_next == NULL) || (p_timer->deadline_ms < p_next->deadline_ms)))
+            p_next = p_timer;
+    }
+    if ((p_next == NULL) || (p_next->deadline_ms > until_ms))
+        return WICED_FALSE;
+
+    if (p_next->deadline_ms > wiced_host.tick_ms)
+        wiced_host.tick_ms = p_next->deadline_ms;
+
+    if ((p_next->type == WICED_SECONDS_PERIODIC_TIMER) || (p_next->type == WICED_MILLI_SECONDS_PERIODIC_TIMER))
+        wiced_start_timer(p_next, p_next->timeout);
+    else
+        p_next->in_use = WICED_FALSE;
+
+    p_next->p_cback(p_next->arg);
+    return WICED_TRUE;
+}
+
+/*
+ * Run all timers which expire until the simulated time and move the clock to it
+ */
+void wiced_host_run_until(uint64_t until_ms)
+{
+    while (wiced_host_run_next(until_ms))
+        ;
+    if (until_ms > wiced_host.tick_ms)
+        wiced_host.tick_ms = until_ms;
+}
+
+/*
+ * Run the timers for the duration from the current simulated time
+ */
+void wiced_host_run(uint32_t duration_ms)
+{
+    wiced_host_run_until(wiced_host.tick_ms + duration_ms);
+}
+
+/*
+ * Write the mesh header of the HCI command as parsed by wiced_bt_mesh_create_event_from_wiced_hci:
+ * destination (2 bytes), application key index (2 bytes), element index, reply, send segmented,
+ * TTL, retransmit count, retransmit interval and reply timeout. Returns the pointer after the header.
+ */
+uint8_t *wiced_host_mesh_hdr(uint8_t *p, uint16_t dst, uint16_t app_key_idx, uint8_t reply)
+{
+    UINT16_TO_STREAM(p, dst);
+    UINT16_TO_STREAM(p, app_key_idx);
+    UINT8_TO_STREAM(p, 0);          // element index
+    UINT8_TO_STREAM(p, reply);
+    UINT8_TO_STREAM(p, 0);          // send segmented
+    UINT8_TO_STREAM(p, 0xFF);       // default TTL
+    UINT8_TO_STREAM(p, 0);          // retransmit count
+    UINT8_TO_STREAM(p, 0);          // retransmit interval
+    UINT8_TO_STREAM(p, 0);          // reply timeout
+    return p;
+}
+
+/*
+ * Deliver status received from the Time Server to the callback of the time client model
+ */
+void wiced_host_status_deliver(uint16_t event, uint16_t src, uint16_t dst, void *p_data)
+{
+    wiced_bt_mesh_event_t *p_event;
+
+    if (wiced_host_time_client_cback == NULL)
+        return;
+
+    p_event = (wiced_bt_mesh_event_t *)calloc(1, sizeof(wiced_bt_mesh_event_t));
+    p_event->company_id = MESH_COMPANY_ID_BT_SIG;
+    p_event->model_id   = WICED_BT_MESH_CORE_MODEL_ID_TIME_CLNT;
+    p_event->src        = src;
+    p_event->dst        = dst;
+    wiced_host.num_events_in_use++;
+
+    wiced_host_time_client_cback(event, p_event, p_data);
+}
+
+/*
+ * Message with the index since the reset, NULL if it is not in the log anymore
+ */
+const wiced_host_mesh_msg_t *wiced_host_mesh_tx_get(uint32_t idx)
+{
+    if ((idx >= wiced_host.num_mesh_tx) || (wiced_host.num_mesh_tx - idx > WICED_HOST_LOG_SIZE) || wiced_host.log_disabled)
+        return NULL;
+    return &wiced_host.mesh_tx[idx & (WICED_HOST_LOG_SIZE - 1)];
+}
+
+/*
+ * HCI event with the index since the reset, NULL if it is not in the log anymore
+ */
+const wiced_host_hci_event_t *wiced_host_hci_event_get(uint32_t idx)
+{
+    if ((idx >= wiced_host.num_hci_events) || (wiced_host.num_hci_events - idx > WICED_HOST_LOG_SIZE) || wiced_host.log_disabled)
+        return NULL;
+    return &wiced_host.hci_event[idx & (WICED_HOST_LOG_SIZE - 1)];
+}
+
+/*
+ * First HCI event with the opcode starting at the index, NULL if there is none
+ */
+const wiced_host_hci_event_t *wiced_host_hci_event_find(uint16_t opcode, uint32_t from)
+{
+    const wiced_host_hci_event_t *p_event;
+
+    for (; from < wiced_host.num_hci_events; from++)
+    {
+        if (((p_event = wiced_host_hci_event_get(from)) != NULL) && (p_event->opcode == opcode))
+            return p_event;
+    }
+    return NULL;
+}
+
+/*
+ * Number of HCI events with the opcode starting at the index
+ */
+uint32_t wiced_host_hci_event_count(uint16_t opcode, uint32_t from)
+{
+    const wiced_host_hci_event_t *p_event;
+    uint32_t count = 0;
+
+    for (; from < wiced_host.num_hci_events; from++)
+    {
+        if (((p_event = wiced_host_hci_event_get(from)) != NULL) && (p_event->opcode == opcode))
+            count++;
+    }
+    return count;
+}
+
+/*
+ * Number of mesh messages with the opcode to the destination starting at the index. Opcode
+ * or destination 0 matches any.
+ */
+uint32_t wiced_host_mesh_tx_count(uint16_t opcode, uint16_t dst, uint32_t from)
+{
+    const wiced_host_mesh_msg_t *p_msg;
+    uint32_t count = 0;
+
+    for (; from < wiced_host.num_mesh_tx; from++)
+    {
+        if (((p_msg = wiced_host_mesh_tx_get(from)) != NULL) &&
+            ((opcode == 0) || (p_msg->opcode == opcode)) && ((dst == 0) || (p_msg->dst == dst)))
+            count++;
+    }
+    return count;
+}
+
+/******************************************************
+ *          Trace, timers, HAL
+ ******************************************************/
+void wiced_bt_trace(const char *p_format, ...)
+{
+    va_list args;
+
+    if (!wiced_host.trace_enabled)
+        return;
+
+    va_start(args, p_format);
+    vprintf(p_format, args);
+    va_end(args);
+}
+
+wiced_result_t wiced_init_timer(wiced_timer_t *p_timer, wiced_timer_callback_t p_cb, TIMER_PARAM_TYPE cb_param, wiced_timer_type_t timer_type)
+{
+    wiced_timer_t *p;
+
+    for (p = wiced_host_timers; (p != NULL) && (p != p_timer); p = p->p_next)
+        ;
+    if (p == NULL)
+    {
+        p_timer->p_next   = wiced_host_timers;
+        wiced_host_timers = p_timer;
+    }
+    p_timer->p_cback = p_cb;
+    p_timer->arg     = cb_param;
+    p_timer->type    = timer_type;
+    p_timer->in_use  = WICED_FALSE;
+    return WICED_SUCCESS;
+}
+
+wiced_result_t wiced_start_timer(wiced_timer_t *p_timer, uint32_t timeout)
+{
+    if (p_timer->p_cback == NULL)
+        return WICED_ERROR;
+
+    p_timer->timeout     = timeout;
+    p_timer->deadline_ms = wiced_host.tick_ms + (((p_timer->type == WICED_SECONDS_TIMER) || (p_timer->type == WICED_SECONDS_PERIODIC_TIMER)) ?
+                                                 (uint64_t)timeout * 1000 : timeout);
+    p_timer->in_use      = WICED_TRUE;
+    return WICED_SUCCESS;
+}
+
+wiced_result_t wiced_stop_timer(wiced_timer_t *p_timer)
+{
+    p_timer->in_use = WICED_FALSE;
+    return WICED_SUCCESS;
+}
+
+wiced_bool_t wiced_is_timer_in_use(wiced_timer_t *p_timer)
+{
+    return p_timer->in_use;
+}
+
+uint32_t wiced_hal_rand_gen_num(void)
+{
+    // xorshift32
+    wiced_host_rand_state ^= wiced_host_rand_state << 13;
+    wiced_host_rand_state ^= wiced_host_rand_state >> 17;
+    wiced_host_rand_state ^= wiced_host_rand_state << 5;
+    return wiced_host_rand_state;
+}
+
+uint16_t wiced_hal_write_nvram(uint16_t vs_id, uint16_t data_length, uint8_t *p_data, wiced_result_t *p_status)
+{
+    wiced_host_nvram_item_t *p_item = NULL;
+    int i;
+
+    for (i = 0; i < WICED_HOST_NVRAM_MAX_ITEMS; i++)
+    {
+        if (wiced_host_nvram[i].vs_id == vs_id)
+        {
+            p_item = &wiced_host_nvram[i];
+            break;
+        }
+        if ((p_item == NULL) && (wiced_host_nvram[i].vs_id == 0))
+            p_item = &wiced_host_nvram[i];
+    }
+    if ((p_item == NULL) || (data_length > WICED_HOST_NVRAM_MAX_LEN))
+    {
+        *p_status = WICED_NO_MEMORY;
+        return 0;
+    }
+    p_item->vs_id  = vs_id;
+    p_item->length = data_length;
+    memcpy(p_item->data, p_data, data_length);
+    wiced_host.num_nvram_write++;
+    *p_status = WICED_SUCCESS;
+    return data_length;
+}
+
+uint16_t wiced_hal_read_nvram(uint16_t vs_id, uint16_t data_length, uint8_t *p_data, wiced_result_t *p_status)
+{
+    int i;
+
+    for (i = 0; i < WICED_HOST_NVRAM_MAX_ITEMS; i++)
+    {
+        if (wiced_host_nvram[i].vs_id == vs_id)
+        {
+            if (data_length > wiced_host_nvram[i].length)
+                data_length = wiced_host_nvram[i].length;
+            memcpy(p_data, wiced_host_nvram[i].data, data_length);
+            *p_status = WICED_SUCCESS;
+            return data_length;
+        }
+    }
+    *p_status = WICED_BADARG;
+    return 0;
+}
+
+wiced_result_t wiced_sleep_enter_hid_off(uint32_t wakeup_time, uint32_t wakeup_pin, uint32_t wakeup_level)
+{
+    wiced_host.num_hid_off++;
+    wiced_host.last_hid_off_ms = wakeup_time;
+    return WICED_SUCCESS;
+}
+
+/******************************************************
+ *          Transport buffers
+ ******************************************************/
+wiced_transport_buffer_pool_t *wiced_transport_create_buffer_pool(uint32_t buffer_size, uint32_t buffer_count)
+{
+    wiced_transport_buffer_pool_t *p_pool;
+    wiced_host_buffer_t *p_buf;
+    uint32_t i;
+
+    p_pool = (wiced_transport_buffer_pool_t *)calloc(1, sizeof(wiced_transport_buffer_pool_t));
+    p_pool->buffer_size  = buffer_size;
+    p_pool->buffer_count = buffer_count;
+    for (i = 0; i < buffer_count; i++)
+    {
+        p_buf = (wiced_host_buffer_t *)calloc(1, sizeof(wiced_host_buffer_t) + buffer_size);
+        p_buf->p_pool  = p_pool;
+        p_buf->p_next  = p_pool->p_free;
+        p_pool->p_free = p_buf;
+    }
+    p_pool->num_free = buffer_count;
+    return p_pool;
+}
+
+void *wiced_transport_allocate_buffer(wiced_transport_buffer_pool_t *p_pool)
+{
+    wiced_host_buffer_t *p_buf = p_pool->p_free;
+
+    if (p_buf == NULL)
+        return NULL;
+
+    p_pool->p_free = p_buf->p_next;
+    p_pool->num_free--;
+    wiced_host.num_hci_events_in_use++;
+    return p_buf + 1;
+}
+
+uint32_t wiced_transport_get_buffer_count(wiced_transport_buffer_pool_t *p_pool)
+{
+    return p_pool->num_free;
+}
+
+void wiced_transport_free_buffer(void *p_data)
+{
+    wiced_host_buffer_t *p_buf = (wiced_host_buffer_t *)p_data - 1;
+    wiced_transport_buffer_pool_t *p_pool = p_buf->p_pool;
+
+    wiced_host.num_hci_events_in_use--;
+    if (p_pool == NULL)
+    {
+        free(p_buf);
+        return;
+    }
+    p_buf->p_next  = p_pool->p_free;
+    p_pool->p_free = p_buf;
+    p_pool->num_free++;
+}
+
+/******************************************************
+ *          Mesh application library and core
+ ******************************************************/
+uint64_t wiced_bt_mesh_core_get_tick_count(void)
+{
+    return wiced_host.tick_ms;
+}
+
+void wiced_bt_mesh_set_raw_scan_response_data(uint8_t num_elem, wiced_bt_ble_advert_elem_t *p_adv)
+{
+}
+
+wiced_bt_mesh_event_t *wiced_bt_mesh_create_event(uint8_t element_idx, uint16_t company_id, uint16_t model_id, uint16_t dst, uint16_t app_key_idx)
+{
+    wiced_bt_mesh_event_t *p_event;
+
+    if (wiced_host.fail_event_alloc)
+        return NULL;
+
+    p_event = (wiced_bt_mesh_event_t *)calloc(1, sizeof(wiced_bt_mesh_event_t));
+    p_event->element_idx = element_idx;
+    p_event->company_id  = company_id;
+    p_event->model_id    = model_id;
+    p_event->dst         = dst;
+    p_event->app_key_idx = app_key_idx;
+    p_event->ttl         = 0xFF;
+    wiced_host.num_events_in_use++;
+    return p_event;
+}
+
+wiced_bt_mesh_event_t *wiced_bt_mesh_create_event_from_wiced_hci(uint16_t opcode, uint16_t company_id, uint16_t model_id, uint8_t **p_data, uint32_t *len)
+{
+    wiced_bt_mesh_event_t *p_event;
+    uint8_t *p = *p_data;
+    uint16_t dst;
+    uint16_t app_key_idx;
+    uint8_t  element_idx;
+
+    if (*len < WICED_HOST_MESH_HDR_LEN)
+        return NULL;
+
+    STREAM_TO_UINT16(dst, p);
+    STREAM_TO_UINT16(app_key_idx, p);
+    STREAM_TO_UINT8(element_idx, p);
+
+    if ((p_event = wiced_bt_mesh_create_event(element_idx, company_id, model_id, dst, app_key_idx)) == NULL)
+        return NULL;
+
+    STREAM_TO_UINT8(p_event->reply, p);
+    STREAM_TO_UINT8(p_event->send_segmented, p);
+    STREAM_TO_UINT8(p_event->ttl, p);
+    STREAM_TO_UINT8(p_event->retrans_cnt, p);
+    STREAM_TO_UINT8(p_event->retrans_time, p);
+    STREAM_TO_UINT8(p_event->reply_timeout, p);
+
+    *p_data = p;
+    *len   -= WICED_HOST_MESH_HDR_LEN;
+    return p_event;
+}
+
+void wiced_bt_mesh_release_event(wiced_bt_mesh_event_t *p_event)
+{
+    wiced_host.num_events_in_use--;
+    free(p_event);
+}
+
+wiced_bt_mesh_hci_event_t *wiced_bt_mesh_create_hci_event(wiced_bt_mesh_event_t *p_event)
+{
+    wiced_host_buffer_t *p_buf;
+    wiced_bt_mesh_hci_event_t *p_hci_event;
+
+    if (wiced_host.fail_hci_event_alloc)
+        return NULL;
+
+    p_buf = (wiced_host_buffer_t *)calloc(1, sizeof(wiced_host_buffer_t) + WICED_HOST_HCI_EVENT_MAX_LEN);
+    p_hci_event = (wiced_bt_mesh_hci_event_t *)(p_buf + 1);
+    p_hci_event->src         = p_event->src;
+    p_hci_event->app_key_idx = p_event->app_key_idx;
+    p_hci_event->element_idx = p_event->element_idx;
+    wiced_host.num_hci_events_lib++;
+    wiced_host.num_hci_events_in_use++;
+    return p_hci_event;
+}
+
+/*
+ * Record the HCI event and release the buffer, as the transport does when the event is sent
+ */
+wiced_result_t mesh_transport_send_data(uint16_t opcode, uint8_t *p_data, uint16_t length)
+{
+    wiced_host_hci_event_t *p_event = &wiced_host.hci_event[wiced_host.num_hci_events & (WICED_HOST_LOG_SIZE - 1)];
+    wiced_host_buffer_t *p_buf = (wiced_host_buffer_t *)p_data - 1;
+
+    // The event must fit the pool buffer it has been written to
+    if ((p_buf->p_pool != NULL) && (length > p_buf->p_pool->buffer_size))
+    {
+        fprintf(stderr, "HCI event 0x%04x length %u overflows the %u byte buffer\n", opcode, length, p_buf->p_pool->buffer_size);
+        abort();
+    }
+
+    if (!wiced_host.log_disabled)
+    {
+        p_event->opcode  = opcode;
+        p_event->length  = length;
+        p_event->tick_ms = wiced_host.tick_ms;
+        memcpy(p_event->data, p_data, (length < WICED_HOST_HCI_EVENT_MAX_LEN) ? length : WICED_HOST_HCI_EVENT_MAX_LEN);
+    }
+    wiced_host.num_hci_events++;
+
+    if (wiced_host.p_hci_event_cback != NULL)
+        wiced_host.p_hci_event_cback(opcode, p_data, length);
+
+    wiced_transport_free_buffer(p_data);
+    return WICED_SUCCESS;
+}
+
+/******************************************************
+ *          Time client model
+ ******************************************************/
+void wiced_bt_mesh_model_time_client_init(wiced_bt_mesh_time_client_callback_t *p_callback, wiced_bool_t is_provisioned)
+{
+    wiced_host_time_client_cback = p_callback;
+}
+
+/*
+ * Record the message sent by the model. The model owns the event and releases it.
+ */
+static wiced_result_t wiced_host_mesh_send(uint16_t opcode, wiced_bt_mesh_event_t *p_event, const void *p_param, size_t param_len)
+{
+    wiced_host_mesh_msg_t msg;
+    wiced_host_mesh_msg_t *p_msg = wiced_host.log_disabled ? &msg : &wiced_host.mesh_tx[wiced_host.num_mesh_tx & (WICED_HOST_LOG_SIZE - 1)];
+
+    memset(p_msg, 0, sizeof(wiced_host_mesh_msg_t));
+    p_msg->opcode      = opcode;
+    p_msg->dst         = p_event->dst;
+    p_msg->app_key_idx = p_event->app_key_idx;
+    p_msg->element_idx = p_event->element_idx;
+    p_msg->ttl         = p_event->ttl;
+    p_msg->reply       = p_event->reply;
+    p_msg->tick_ms     = wiced_host.tick_ms;
+    if (p_param != NULL)
+        memcpy(&p_msg->param, p_param, param_len);
+    wiced_host.num_mesh_tx++;
+
+    wiced_bt_mesh_release_event(p_event);
+
+    if (wiced_host.p_mesh_tx_cback != NULL)
+        wiced_host.p_mesh_tx_cback(p_msg);
+    return WICED_SUCCESS;
+}
+
+wiced_result_t wiced_bt_mesh_model_time_client_time_get_send(wiced_bt_mesh_event_t *p_event)
+{
+    return wiced_host_mesh_send(HCI_CONTROL_MESH_COMMAND_TIME_GET, p_event, NULL, 0);
+}
+
+wiced_result_t wiced_bt_mesh_model_time_client_time_set_send(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_time_state_msg_t *p_data)
+{
+    return wiced_host_mesh_send(HCI_CONTROL_MESH_COMMAND_TIME_SET, p_event, p_data, sizeof(*p_data));
+}
+
+wiced_result_t wiced_bt_mesh_model_time_client_time_zone_get_send(wiced_bt_mesh_event_t *p_event)
+{
+    return wiced_host_mesh_send(HCI_CONTROL_MESH_COMMAND_TIME_ZONE_GET, p_event, NULL, 0);
+}
+
+wiced_result_t wiced_bt_mesh_model_time_client_time_zone_set_send(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_time_zone_set_t *p_data)
+{
+    return wiced_host_mesh_send(HCI_CONTROL_MESH_COMMAND_TIME_ZONE_SET, p_event, p_data, sizeof(*p_data));
+}
+
+wiced_result_t wiced_bt_mesh_model_time_client_tai_utc_delta_get_send(wiced_bt_mesh_event_t *p_event)
+{
+    return wiced_host_mesh_send(HCI_CONTROL_MESH_COMMAND_TIME_TAI_UTC_DELTA_GET, p_event, NULL, 0);
+}
+
+wiced_result_t wiced_bt_mesh_model_time_client_tai_utc_delta_set_send(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_time_tai_utc_delta_set_t *p_data)
+{
+    return wiced_host_mesh_send(HCI_CONTROL_MESH_COMMAND_TIME_TAI_UTC_DELTA_SET, p_event, p_data, sizeof(*p_data));
+}
+
+wiced_result_t wiced_bt_mesh_model_time_client_time_role_get_send(wiced_bt_mesh_event_t *p_event)
+{
+    return wiced_host_mesh_send(HCI_CONTROL_MESH_COMMAND_TIME_ROLE_GET, p_event, NULL, 0);
+}
+
+wiced_result_t wiced_bt_mesh_model_time_client_time_role_set_send(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_time_role_msg_t *p_data)
+{
+    return wiced_host_mesh_send(HCI_CONTROL_MESH_COMMAND_TIME_ROLE_SET, p_event, p_data, sizeof(*p_data));
+}
@@ -41,13 +41,22 @@
 #include "wiced_bt_mesh_models.h"
 #include "wiced_bt_trace.h"
 #include "rtc.h"
+#include "wiced_timer.h"
+#include "wiced_hal_nvram.h"
+#include "wiced_hal_rand.h"
 #include "wiced_bt_mesh_app.h"
+#include "mesh_time_client.h"
+#include "mesh_time_client_trace.h"
+#include "wiced_transport.h"
 
 #ifdef HCI_CONTROL
-#include "wiced_transport.h"
 #include "hci_control_api.h"
 #endif
 
+#if LOW_POWER_NODE
+#include "wiced_sleep.h"
+#endif
+
 #include "wiced_bt_cfg.h"
 extern wiced_bt_cfg_settings_t wiced_bt_cfg_settings;
 
@@ -57,9 +66,474 @@ extern wiced_bt_cfg_settings_t wiced_bt_cfg_settings;
 #define MESH_PID                0x3023
 #define MESH_VID                0x0002
 
+// Application specific WICED HCI commands and events. The time client uses the top of the
+// mesh group opcode range which is not assigned to the common mesh commands in hci_control_api.h.
+#define HCI_CONTROL_MESH_COMMAND_TIME_GET_BATCH         ((HCI_CONTROL_GROUP_MESH << 8) | 0xE0)  /* Get time from a list of Time Servers */
+#define HCI_CONTROL_MESH_COMMAND_TIME_GET_CACHED        ((HCI_CONTROL_GROUP_MESH << 8) | 0xE1)  /* Get time from the cache, or from the Time Server if stale */
+#define HCI_CONTROL_MESH_COMMAND_TIME_SERVER_RANKING_GET ((HCI_CONTROL_GROUP_MESH << 8) | 0xE2) /* Get Time Servers ranking and filtered offset */
+#define HCI_CONTROL_MESH_COMMAND_TIME_SYNC_SCHEDULER_SET ((HCI_CONTROL_GROUP_MESH << 8) | 0xE3) /* Configure periodic time sync */
+#define HCI_CONTROL_MESH_COMMAND_TIME_SYNC_SCHEDULER_GET ((HCI_CONTROL_GROUP_MESH << 8) | 0xE4) /* Get state of periodic time sync */
+#define HCI_CONTROL_MESH_COMMAND_TIME_NOW_GET           ((HCI_CONTROL_GROUP_MESH << 8) | 0xE5)  /* Get mesh time of the local clock */
+#define HCI_CONTROL_MESH_COMMAND_LOCAL_TIME_GET         ((HCI_CONTROL_GROUP_MESH << 8) | 0xE6)  /* Convert TAI to UTC and local time */
+#define HCI_CONTROL_MESH_COMMAND_TIME_CLIENT_POOL_STATS_GET ((HCI_CONTROL_GROUP_MESH << 8) | 0xE7) /* Get allocation statistics */
+#define HCI_CONTROL_MESH_COMMAND_TIME_CLIENT_STATS_GET  ((HCI_CONTROL_GROUP_MESH << 8) | 0xE8)  /* Get message counters and round trip histograms */
+#define HCI_CONTROL_MESH_COMMAND_TIME_COMMAND_BATCH     ((HCI_CONTROL_GROUP_MESH << 8) | 0xE9)  /* Send a sequence of time commands */
+#define HCI_CONTROL_MESH_COMMAND_TIME_PACING_SET        ((HCI_CONTROL_GROUP_MESH << 8) | 0xEA)  /* Configure rate of the outgoing set messages */
+#define HCI_CONTROL_MESH_COMMAND_TIME_PACING_GET        ((HCI_CONTROL_GROUP_MESH << 8) | 0xEB)  /* Get pacing configuration and queue statistics */
+#define HCI_CONTROL_MESH_COMMAND_TIME_LPN_SET           ((HCI_CONTROL_GROUP_MESH << 8) | 0xEC)  /* Enable deferral of the gets to the friend poll */
+#define HCI_CONTROL_MESH_COMMAND_TIME_LPN_GET           ((HCI_CONTROL_GROUP_MESH << 8) | 0xED)  /* Get Low Power Node energy statistics */
+#define HCI_CONTROL_MESH_COMMAND_TIME_PROXY_SET         ((HCI_CONTROL_GROUP_MESH << 8) | 0xEE)  /* Configure time updates to the attached Low Power Nodes */
+#define HCI_CONTROL_MESH_COMMAND_TIME_PROXY_GET         ((HCI_CONTROL_GROUP_MESH << 8) | 0xEF)  /* Get time update configuration and counters */
+#define HCI_CONTROL_MESH_COMMAND_TIME_ELECTION_START    ((HCI_CONTROL_GROUP_MESH << 8) | 0xF0)  /* Elect Time Authority and Time Relays */
+#define HCI_CONTROL_MESH_COMMAND_TIME_ELECTION_GET      ((HCI_CONTROL_GROUP_MESH << 8) | 0xF1)  /* Get result of the last election */
+#define HCI_CONTROL_MESH_COMMAND_TIME_CAPTURE_SET       ((HCI_CONTROL_GROUP_MESH << 8) | 0xF2)  /* Start or stop capture of the HCI frames */
+#define HCI_CONTROL_MESH_COMMAND_TIME_CAPTURE_GET       ((HCI_CONTROL_GROUP_MESH << 8) | 0xF3)  /* Read captured HCI frames */
+
+#define HCI_CONTROL_MESH_EVENT_TIME_GET_BATCH_STATUS    ((HCI_CONTROL_GROUP_MESH << 8) | 0xE0)  /* Aggregated Time Status of a batch get */
+#define HCI_CONTROL_MESH_EVENT_TIME_SERVER_RANKING      ((HCI_CONTROL_GROUP_MESH << 8) | 0xE1)  /* Time Servers ordered by the quality of their time */
+#define HCI_CONTROL_MESH_EVENT_TIME_OFFSET_STATUS       ((HCI_CONTROL_GROUP_MESH << 8) | 0xE2)  /* Filtered offset to the best Time Server */
+#define HCI_CONTROL_MESH_EVENT_TIME_SYNC_SCHEDULER_STATUS ((HCI_CONTROL_GROUP_MESH << 8) | 0xE3) /* State of periodic time sync */
+#define HCI_CONTROL_MESH_EVENT_TIME_NOW_STATUS          ((HCI_CONTROL_GROUP_MESH << 8) | 0xE4)  /* Mesh time of the local clock */
+#define HCI_CONTROL_MESH_EVENT_LOCAL_TIME_STATUS        ((HCI_CONTROL_GROUP_MESH << 8) | 0xE5)  /* UTC and local time */
+#define HCI_CONTROL_MESH_EVENT_TIME_CLIENT_TRACE        ((HCI_CONTROL_GROUP_MESH << 8) | 0xE6)  /* Binary trace records, see mesh_time_client_trace.h */
+#define HCI_CONTROL_MESH_EVENT_TIME_REQUEST_TIMEOUT     ((HCI_CONTROL_GROUP_MESH << 8) | 0xE7)  /* Get command has not been answered after all retries */
+#define HCI_CONTROL_MESH_EVENT_TIME_CLIENT_POOL_STATS   ((HCI_CONTROL_GROUP_MESH << 8) | 0xE8)  /* Allocation statistics */
+#define HCI_CONTROL_MESH_EVENT_TIME_CLIENT_STATS        ((HCI_CONTROL_GROUP_MESH << 8) | 0xE9)  /* Per opcode counters and round trip histograms */
+#define HCI_CONTROL_MESH_EVENT_TIME_CLIENT_DST_STATS    ((HCI_CONTROL_GROUP_MESH << 8) | 0xEA)  /* Per destination counters */
+#define HCI_CONTROL_MESH_EVENT_TIME_COMMAND_BATCH_STATUS ((HCI_CONTROL_GROUP_MESH << 8) | 0xEB) /* Bitmaps of the sent and the queued commands of the batch */
+#define HCI_CONTROL_MESH_EVENT_TIME_PACING_STATUS       ((HCI_CONTROL_GROUP_MESH << 8) | 0xEC)  /* Pacing configuration and queue statistics */
+#define HCI_CONTROL_MESH_EVENT_TIME_LPN_STATUS          ((HCI_CONTROL_GROUP_MESH << 8) | 0xED)  /* Low Power Node energy statistics */
+#define HCI_CONTROL_MESH_EVENT_TIME_PROXY_STATUS        ((HCI_CONTROL_GROUP_MESH << 8) | 0xEE)  /* Time update configuration and counters */
+#define HCI_CONTROL_MESH_EVENT_TIME_ELECTION_STATUS     ((HCI_CONTROL_GROUP_MESH << 8) | 0xEF)  /* Elected Time Authority and Time Relays */
+#define HCI_CONTROL_MESH_EVENT_TIME_CAPTURE_DATA        ((HCI_CONTROL_GROUP_MESH << 8) | 0xF0)  /* Block of the capture buffer */
+
+#define MESH_TIME_STATE_MSG_LEN                 11      // Time Status as sent over HCI: TAI(5), subsecond, uncertainty, authority, TAI-UTC delta(2), zone offset
+
+#define MESH_TIME_BATCH_MAX_DST                 200     // Max number of Time Servers in one batch get
+#define MESH_TIME_BATCH_ENTRIES_PER_EVENT       16      // Number of batch results reported in one HCI event
+#define MESH_TIME_BATCH_DEFAULT_TIMEOUT         ((MESH_TIME_REQUEST_TIMEOUT * ((2 << MESH_TIME_REQUEST_MAX_RETRIES) - 1) + 999) / 1000)
+                                                        // Seconds to wait for all replies if the host does not specify the deadline, all retries of the last get
+#define MESH_TIME_BATCH_RESERVED_REQUESTS       4       // Request tracker entries left to the host and the time sync, batch gets wait for a free one
+
+#define MESH_TIME_CLIENT_MAX_SERVERS            32      // Number of Time Servers the client keeps state for
+#define MESH_TIME_CACHE_DRIFT_PPM               100     // Worst case clock drift used to grow the uncertainty of an aged cached time
+
+#define MESH_TIME_FILTER_SIZE                   8       // Number of round trip samples kept per server for the NTP style clock filter
+#define MESH_TIME_NO_AUTHORITY_PENALTY_MS       500     // Added to the score of a server which is not a Time Authority
+#define MESH_TIME_RANKING_MAX_REPORT            16      // Max number of servers reported in the ranking event
+
+#define MESH_TIME_SYNC_MAX_SERVERS              8       // Max number of Time Servers polled by the periodic time sync
+#define MESH_TIME_SYNC_MAX_OFFSET_CHANGE        1000000 // Max change of the offset in milliseconds between polls considered as drift
+#define MESH_TIME_SYNC_RESTORE_DELAY            2       // Delay in seconds of the first poll of the time sync restored from NVRAM
+#define MESH_TIME_SYNC_CONFIG_NVRAM_ID          WICED_NVRAM_VSID_START  // NVRAM ID to save the periodic time sync configuration
+
+#define MESH_TIME_CLOCK_STEP_THRESHOLD_US       500000  // Phase error which is stepped instead of slewed
+#define MESH_TIME_CLOCK_MAX_SLEW_PPM            500     // Max rate of the phase correction
+#define MESH_TIME_CLOCK_MAX_FREQ_PPB            500000  // Max frequency correction of the local clock
+#define MESH_TIME_CLOCK_FLL_GAIN                4       // Fraction (1/N) of the measured frequency error applied per update
+#define MESH_TIME_CLOCK_FLL_MIN_INTERVAL_MS     256000  // Frequency errors measured over shorter intervals are scaled down, the delay jitter dominates them
+#define MESH_TIME_CLOCK_HOLDOVER_PPM            20      // Residual drift of the disciplined clock used to grow the uncertainty
+#define MESH_TIME_CLOCK_MAX_DELAY_FACTOR        2       // Samples with delay above N times the filtered delay are not used
+
+#define MESH_TIME_SCHEDULE_SIZE                 4       // Max number of pending time zone and TAI-UTC delta changes
+#define MESH_TIME_ZONE_OFFSET_BIAS              0x40    // Time zone offset is sent in 15 minutes units biased by 0x40
+#define MESH_TIME_TAI_UTC_DELTA_BIAS            0xFF    // TAI-UTC delta is sent in seconds biased by 0xFF
+#define MESH_TIME_SECONDS_PER_DAY               86400
+#define MESH_TIME_DAYS_0000_03_01_TO_2000_01_01 730425  // Days from the start of the proleptic Gregorian era to the mesh epoch
+
+#define MESH_TIME_TRACE_RING_SIZE               64      // Number of trace records in the ring, power of 2
+#define MESH_TIME_TRACE_RECORDS_PER_EVENT       16      // Max number of trace records sent in one HCI event
+#define MESH_TIME_TRACE_DRAIN_DELAY             20      // Delay in milliseconds to drain the traces after the first record
+
+#define MESH_TIME_HCI_EVENT_POOL_BUF_SIZE       422     // Size of the HCI event buffer: header (5) and statistics (17 + 8 opcodes * 50), the largest event
+#define MESH_TIME_HCI_EVENT_POOL_COUNT          8       // Number of HCI event buffers reserved for the time client
+
+#define MESH_TIME_REQUEST_POOL_SIZE             16      // Max number of get requests tracked at the same time
+#define MESH_TIME_REQUEST_TIMEOUT               3000    // Milliseconds to wait for the reply before the first retry
+#define MESH_TIME_REQUEST_MAX_RETRIES           2       // Number of retries, the timeout is doubled after each retry
+
+#define MESH_TIME_COMMAND_FLAG_MESH_HDR         0x01    // Command data starts with the mesh header
+#define MESH_TIME_COMMAND_FLAG_REQUEST          0x02    // Get tracked by the request tracker
+#define MESH_TIME_COMMAND_FLAG_PACED            0x04    // Set sent through the pacing queue
+#define MESH_TIME_COMMAND_FLAG_BATCH            0x08    // Command can be sent in the command batch
+#define MESH_TIME_COMMAND_FLAG_NO_CAPTURE       0x10    // Command is not recorded by the capture
+
+#define MESH_TIME_COMMAND_BATCH_MAX             64      // Max number of sub-commands in one batch, multiple of 8
+#define MESH_TIME_SET_PARAM_LEN                 11      // TAI seconds (5), subsecond, uncertainty, authority, TAI-UTC delta (2), zone offset
+#define MESH_TIME_ZONE_SET_PARAM_LEN            6       // New zone offset, TAI of the zone change (5)
+#define MESH_TIME_TAI_UTC_DELTA_SET_PARAM_LEN   7       // New TAI-UTC delta (2), TAI of the delta change (5)
+#define MESH_TIME_ROLE_SET_PARAM_LEN            1       // Time role
+#define MESH_TIME_GET_BATCH_PARAM_LEN           2       // Timeout, number of servers
+#define MESH_TIME_SYNC_SCHEDULER_SET_PARAM_LEN  8       // Enabled, min and max interval (2 each), target accuracy (2), number of servers
+#define MESH_TIME_PACING_SET_PARAM_LEN          4       // Rate, burst, jitter (2)
+#define MESH_TIME_LPN_SET_PARAM_LEN             1       // Deferral enabled
+#define MESH_TIME_PROXY_SET_PARAM_LEN           6       // Element, app key index (2), update polls (2), number of nodes
+#define MESH_TIME_ELECTION_START_PARAM_LEN      6       // Number of relays, max score (2), monitoring interval (2), number of candidates
+#define MESH_TIME_CAPTURE_SET_PARAM_LEN         1       // Capture enabled
+
+#define MESH_TIME_PACE_QUEUE_SIZE               16      // Max number of set messages waiting to be sent
+#define MESH_TIME_PACE_DEFAULT_RATE             10      // Set messages per second, 0 to send without pacing
+#define MESH_TIME_PACE_DEFAULT_BURST            4       // Max number of set messages sent back to back
+#define MESH_TIME_PACE_DEFAULT_JITTER           20      // Max random delay in milliseconds before each paced message
+
+#define MESH_TIME_LPN_QUEUE_SIZE                8       // Max number of gets waiting for the friend poll
+#define MESH_TIME_LPN_MAX_DEFER                 10000   // Max milliseconds a get waits for the friend poll
+
+#define MESH_TIME_PROXY_MAX_LPN                 4       // Max number of Low Power Nodes receiving time updates, same as max_lpn_num
+#define MESH_TIME_PROXY_SEND_ADVANCE            100     // Time update is sent this number of milliseconds before the predicted poll
+
+#define MESH_TIME_ELECTION_MAX_CANDIDATES       16      // Max number of Time Servers taking part in the election
+#define MESH_TIME_ELECTION_MAX_RELAYS           4       // Max number of Time Relays assigned by the election
+#define MESH_TIME_ELECTION_SURVEY_TIMEOUT       10      // Seconds to wait for the time and role statuses of the candidates
+#define MESH_TIME_ELECTION_MAX_MISSED           3       // Election is run again if the authority does not reply N monitoring gets
+
+#define MESH_TIME_ROLE_NONE                     0       // Time Role values of the Time Role Status
+#define MESH_TIME_ROLE_AUTHORITY                1
+#define MESH_TIME_ROLE_RELAY                    2
+#define MESH_TIME_ROLE_CLIENT                   3
+
+#define MESH_TIME_STATUS_SUCCESS                0       // Status of the configuration reported to the host
+#define MESH_TIME_STATUS_INVALID_PARAM          1       // Configuration rejected, the previous one is kept
+
+#ifndef MESH_TIME_CLIENT_CAPTURE
+#define MESH_TIME_CLIENT_CAPTURE                0       // Set to 1 to capture the HCI commands and events in RAM
+#endif
+#define MESH_TIME_CAPTURE_BUF_SIZE              2048    // Size of the capture buffer including the header
+#define MESH_TIME_CAPTURE_HDR_LEN               8       // Magic (4 bytes) and local time of the capture start (4 bytes)
+#define MESH_TIME_CAPTURE_RECORD_HDR_LEN        9       // Record length (2), direction, opcode (2) and local time (4)
+#define MESH_TIME_CAPTURE_DATA_PER_EVENT        256     // Max number of capture bytes sent in one HCI event
+#define MESH_TIME_CAPTURE_DIR_COMMAND           0       // Record of the HCI command received from the host
+#define MESH_TIME_CAPTURE_DIR_EVENT             1       // Record of the HCI event sent to the host
+
+#define MESH_TIME_STATS_NUM_OPCODES             8       // Time, zone, TAI-UTC delta and role get and set commands
+#define MESH_TIME_STATS_NUM_STATUSES            4       // Time, zone, TAI-UTC delta and role status
+#define MESH_TIME_STATS_NUM_DST                 16      // Max number of destinations with counters
+#define MESH_TIME_STATS_NUM_BUCKETS             16      // Round trip histogram bucket N counts replies in [2^N, 2^(N+1)) ms
+
+#define MESH_TIME_SERVER_FLAG_TIME_VALID        0x01    // Time Status has been received
+#define MESH_TIME_SERVER_FLAG_ZONE_VALID        0x02    // Time Zone Status has been received
+#define MESH_TIME_SERVER_FLAG_DELTA_VALID       0x04    // TAI-UTC Delta Status has been received
+
+#define MESH_TIME_SERVER_FIND                   0       // Only look up the known server
+#define MESH_TIME_SERVER_CREATE                 1       // Take an unused entry or an entry without samples
+#define MESH_TIME_SERVER_CREATE_SAMPLED         2       // Also take the oldest entry with samples, the new entry receives a sample
+
 /******************************************************
  *          Structures
  ******************************************************/
+typedef struct
+{
+    uint16_t                dst;                                // Time Server address
+    uint8_t                 replied;                            // WICED_TRUE if Time Status has been received
+    uint8_t                 done;                               // WICED_TRUE if replied or all retries of the get have been used
+    uint8_t                 state[MESH_TIME_STATE_MSG_LEN];     // Received Time Status in the HCI format
+} mesh_time_batch_entry_t;
+
+typedef struct
+{
+    wiced_bool_t            in_progress;                        // WICED_TRUE while waiting for the replies
+    uint16_t                num_dst;                            // Number of Time Servers in the batch
+    uint16_t                num_replied;                        // Number of Time Servers which replied
+    uint16_t                num_done;                           // Number of Time Servers which replied or did not reply to all retries
+    uint16_t                num_sent;                           // Number of Time Gets sent, the rest wait for the pacing tokens and the request tracker
+    uint8_t                 timeout;                            // Deadline in seconds counted from the last Time Get
+    wiced_bt_mesh_event_t   hdr;                                // Copy of the command header used to address the get messages
+    wiced_timer_t           timer;                              // Batch deadline
+    mesh_time_batch_entry_t entry[MESH_TIME_BATCH_MAX_DST];
+} mesh_time_batch_t;
+
+typedef struct
+{
+    int64_t                                     offset_ms;      // Server time minus local time at the reception of the status
+    uint32_t                                    delay_ms;       // Round trip delay of the exchange
+} mesh_time_sample_t;
+
+typedef struct
+{
+    uint16_t                                    addr;           // Time Server address, 0 if the entry is not used
+    uint8_t                                     flags;          // MESH_TIME_SERVER_FLAG_XXX
+    uint64_t                                    time_rx_ms;     // Local time in milliseconds when the Time Status has been received
+    wiced_bt_mesh_time_state_msg_t              time;           // Last received Time Status
+    wiced_bt_mesh_time_zone_status_t            zone;           // Last received Time Zone Status
+    wiced_bt_mesh_time_tai_utc_delta_status_t   delta;          // Last received TAI-UTC Delta Status
+    uint8_t                                     num_samples;    // Number of valid entries in the sample array
+    uint8_t                                     sample_idx;     // Position for the next sample
+    mesh_time_sample_t                          sample[MESH_TIME_FILTER_SIZE];
+    int64_t                                     offset_ms;      // Filtered offset, offset of the sample with the lowest delay
+    uint32_t                                    delay_ms;       // Delay of the selected sample
+    uint32_t                                    jitter_ms;      // Mean deviation of the sample offsets from the filtered offset
+} mesh_time_server_t;
+
+typedef struct
+{
+    uint8_t                 enabled;                            // WICED_TRUE if periodic time sync is running
+    uint8_t                 element_idx;                        // Element used to send Time Get
+    uint16_t                app_key_idx;                        // Application key used to send Time Get
+    uint8_t                 ttl;                                // TTL of the Time Get messages
+    uint16_t                min_interval;                       // Shortest polling interval in seconds
+    uint16_t                max_interval;                       // Longest polling interval in seconds
+    uint16_t                target_accuracy;                    // Accuracy in milliseconds to be kept between polls
+    uint8_t                 num_servers;                        // Number of Time Servers to poll
+    uint16_t                server[MESH_TIME_SYNC_MAX_SERVERS]; // Time Server addresses
+} mesh_time_sync_config_t;
+
+typedef struct
+{
+    mesh_time_sync_config_t config;
+    wiced_timer_t           timer;                              // Poll timer
+    uint16_t                interval;                           // Current polling interval in seconds
+    int32_t                 drift_ppb;                          // Last measured drift of the local clock relative to the servers
+    uint32_t                num_polls;                          // Number of polls since the start
+    int64_t                 prev_offset_ms[MESH_TIME_SYNC_MAX_SERVERS]; // Offset measured in the previous poll of each server
+    uint64_t                prev_rx_ms[MESH_TIME_SYNC_MAX_SERVERS];     // Local time of the previous reply, 0 if none
+} mesh_time_sync_t;
+
+typedef struct
+{
+    wiced_bool_t            valid;                              // WICED_TRUE after the first accepted Time Status
+    uint64_t                ref_tick_ms;                        // Local time of the last update
+    int64_t                 ref_time_us;                        // TAI time in microseconds at ref_tick_ms
+    int32_t                 freq_ppb;                           // Estimated frequency error of the local clock
+    int64_t                 phase_us;                           // Phase error still to be slewed
+    uint32_t                uncertainty_ms;                     // Uncertainty of the time at the last update
+    uint16_t                tai_utc_delta;                      // TAI-UTC delta reported by the source
+    uint8_t                 time_zone_offset;                   // Time zone offset reported by the source
+    uint8_t                 time_authority;                     // Time authority of the source
+    uint16_t                source;                             // Address of the server used for the last update
+    uint32_t                num_updates;                        // Number of accepted samples
+    uint32_t                num_steps;                          // Number of phase steps
+} mesh_time_clock_t;
+
+typedef struct
+{
+    uint64_t                tai;                                // TAI seconds when the new value takes effect
+    uint16_t                value;                              // New time zone offset or TAI-UTC delta, as sent over the air
+} mesh_time_transition_t;
+
+typedef struct
+{
+    uint64_t                day_start;                          // Seconds since 2000-01-01 at the start of the cached day, 0xFF.. if none
+    mesh_time_client_date_t date;                               // Date of the cached day
+} mesh_time_day_cache_t;
+
+typedef struct
+{
+    uint8_t                 zone_offset;                        // Current time zone offset
+    uint16_t                tai_utc_delta;                      // Current TAI-UTC delta
+    uint8_t                 num_zone_changes;
+    uint8_t                 num_delta_changes;
+    mesh_time_transition_t  zone_change[MESH_TIME_SCHEDULE_SIZE];   // Pending zone changes ordered by TAI
+    mesh_time_transition_t  delta_change[MESH_TIME_SCHEDULE_SIZE];  // Pending TAI-UTC delta changes ordered by TAI
+    mesh_time_day_cache_t   utc_day;                            // Last converted UTC day
+    mesh_time_day_cache_t   local_day;                          // Last converted local day
+} mesh_time_conversion_t;
+
+typedef struct
+{
+    uint32_t                time_ms;                            // Local time of the trace
+    uint8_t                 id;                                 // MESH_TIME_TRACE_ID_XXX
+    uint8_t                 level;                              // MESH_TIME_TRACE_LEVEL_XXX
+    uint32_t                arg[3];                             // Raw trace arguments
+} mesh_time_trace_record_t;
+
+typedef struct
+{
+    wiced_bool_t            initialized;                        // WICED_TRUE when the drain timer can be started
+    volatile uint16_t       head;                               // Next record to write, only changed by the writer
+    volatile uint16_t       tail;                               // Next record to drain, only changed by the reader
+    uint16_t                dropped;                            // Records dropped because the ring was full
+    wiced_timer_t           timer;                              // Drain timer
+    mesh_time_trace_record_t record[MESH_TIME_TRACE_RING_SIZE];
+} mesh_time_trace_t;
+
+typedef void (*mesh_time_mesh_command_handler_t)(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length);
+typedef void (*mesh_time_local_command_handler_t)(uint8_t *p_data, uint32_t length);
+
+typedef struct
+{
+    uint16_t                            opcode;                 // HCI command
+    uint8_t                             flags;                  // MESH_TIME_COMMAND_FLAG_XXX
+    uint8_t                             param_len;              // Min length of the parameters, after the mesh header if present
+    mesh_time_mesh_command_handler_t    p_mesh_handler;         // Handler of the command with the mesh header
+    mesh_time_local_command_handler_t   p_local_handler;        // Handler of the command processed locally
+} mesh_time_command_t;
+
+typedef struct
+{
+    uint16_t                opcode;                             // HCI get command, 0 if the entry is free
+    const mesh_time_command_t *p_cmd;                           // Descriptor of the get command
+    uint16_t                dst;                                // Destination of the get
+    uint8_t                 num_waiters;                        // Number of host requests waiting for the reply
+    uint8_t                 retries;                            // Number of retries left
+    uint32_t                timeout;                            // Current timeout in milliseconds
+    uint64_t                deadline_ms;                        // Local time of the next retry or of the timeout
+    uint64_t                tx_ms;                              // Local time of the first transmission, 0 after a retry
+    wiced_bt_mesh_event_t   hdr;                                // Copy of the command header to retry the get
+} mesh_time_request_t;
+
+typedef struct
+{
+    wiced_timer_t           timer;                              // Fires at the earliest deadline of the pending requests
+    uint8_t                 high_water;                         // Max number of requests tracked at the same time
+    uint32_t                num_untracked;                      // Number of gets sent untracked because the pool was full
+    mesh_time_request_t     request[MESH_TIME_REQUEST_POOL_SIZE];
+} mesh_time_request_pool_t;
+
+typedef struct
+{
+    uint16_t                opcode;                             // HCI set command, 0 if the entry is free
+    const mesh_time_command_t *p_cmd;                           // Descriptor of the set command
+    uint8_t                 param_len;                          // Length of the set parameters
+    uint32_t                seq;                                // Arrival order
+    uint8_t                 param[MESH_TIME_SET_PARAM_LEN];     // Set parameters, the longest is Time Set
+    wiced_bt_mesh_event_t   hdr;                                // Copy of the command header
+} mesh_time_pace_entry_t;
+
+typedef struct
+{
+    wiced_timer_t           timer;                              // Fires when the next message can be sent
+    wiced_bool_t            timer_running;                      // WICED_TRUE while waiting for the timer
+    wiced_bool_t            jitter_wait;                        // WICED_TRUE if the timer has been started for the random delay
+    uint8_t                 rate;                               // Messages per second, 0 to send without pacing
+    uint8_t                 burst;                              // Size of the token bucket
+    uint16_t                jitter_ms;                          // Max random delay before each message
+    uint32_t                tokens;                             // Available tokens in 1/1000 of a message
+    uint64_t                refill_ms;                          // Local time when the bucket has been refilled
+    uint16_t                last_dst;                           // Destination of the last sent message
+    uint32_t                seq;                                // Arrival order of the next message
+    uint8_t                 depth;                              // Number of messages in the queue
+    uint8_t                 high_water;                         // Max number of messages in the queue
+    uint32_t                num_queued;                         // Number of messages queued
+    uint32_t                num_sent;                           // Number of messages sent from the queue
+    uint32_t                num_dropped;                        // Number of messages dropped because the queue was full
+    mesh_time_pace_entry_t  entry[MESH_TIME_PACE_QUEUE_SIZE];
+} mesh_time_pace_t;
+
+typedef struct
+{
+    uint16_t                opcode;                             // HCI get command, 0 if the entry is free
+    wiced_bool_t            host;                               // WICED_TRUE if the get is requested by the host
+    wiced_bt_mesh_event_t   hdr;                                // Copy of the header with the destination
+} mesh_time_lpn_entry_t;
+
+typedef struct
+{
+    wiced_timer_t           timer;                              // Fires before the friend poll or at the max deferral time
+    wiced_bool_t            enabled;                            // Gets are deferred to the friend poll
+    wiced_bool_t            flushing;                           // Deferred gets are being sent
+    uint8_t                 depth;                              // Number of deferred gets
+    uint64_t                awake_ms;                           // Local time when the node is expected to wake up
+    uint32_t                num_sleep;                          // Number of sleep periods
+    uint32_t                num_deferred;                       // Number of deferred gets
+    uint32_t                num_tx_wakeups;                     // Number of radio activities started by the time client
+    uint32_t                num_syncs;                          // Number of Time Status messages received
+    uint32_t                on_time_ms;                         // Time awake between the sleep periods
+    mesh_time_lpn_entry_t   entry[MESH_TIME_LPN_QUEUE_SIZE];
+} mesh_time_lpn_t;
+
+typedef struct
+{
+    uint16_t                addr;                               // Address of the Low Power Node
+    uint16_t                polls_to_update;                    // Number of polls until the next time update
+    uint32_t                poll_interval_ms;                   // Poll interval of the Low Power Node
+    uint64_t                next_poll_ms;                       // Predicted local time of the next poll
+    uint32_t                num_updates;                        // Number of time updates sent
+} mesh_time_proxy_lpn_t;
+
+typedef struct
+{
+    wiced_timer_t           timer;                              // Fires before the earliest predicted poll
+    uint8_t                 element_idx;                        // Element used to send the time updates
+    uint16_t                app_key_idx;                        // Application key used to send the time updates
+    uint16_t                update_polls;                       // Time update is sent every N polls of the Low Power Node
+    uint8_t                 num_lpn;                            // Number of Low Power Nodes receiving time updates
+    uint32_t                num_skipped;                        // Updates not sent because the local time is not known
+    mesh_time_proxy_lpn_t   lpn[MESH_TIME_PROXY_MAX_LPN];
+} mesh_time_proxy_t;
+
+typedef enum
+{
+    MESH_TIME_ELECTION_STATE_IDLE,                              // No election configured
+    MESH_TIME_ELECTION_STATE_SURVEY,                            // Waiting for the time and role statuses of the candidates
+    MESH_TIME_ELECTION_STATE_MONITOR,                           // Roles assigned, quality of the authority is monitored
+} mesh_time_election_state_t;
+
+typedef struct
+{
+    uint16_t                addr;                               // Address of the Time Server
+    uint8_t                 role;                               // Role reported by the server, 0xFF if not known
+    wiced_bool_t            replied;                            // Time Status received during the survey
+} mesh_time_election_candidate_t;
+
+typedef struct
+{
+    wiced_timer_t           timer;                              // Survey timeout or monitoring interval
+    uint8_t                 state;                              // MESH_TIME_ELECTION_STATE_XXX
+    wiced_bt_mesh_event_t   hdr;                                // Addressing parameters of the gets and sets
+    uint8_t                 num_relays;                         // Number of Time Relays to assign
+    uint16_t                max_score_ms;                       // Election is run again if the score of the authority exceeds the value, 0 to ignore
+    uint16_t                monitor_interval;                   // Seconds between the gets to the authority, 0 to disable monitoring
+    uint8_t                 num_missed;                         // Number of monitoring gets not answered by the authority
+    uint64_t                get_ms;                             // Local time of the last monitoring get, 0 before the first one
+    uint16_t                authority;                          // Elected Time Authority, 0 if none
+    uint8_t                 num_elected_relays;                 // Number of elected Time Relays
+    uint16_t                relay[MESH_TIME_ELECTION_MAX_RELAYS]; // Elected Time Relays
+    uint32_t                num_elections;                      // Number of completed elections
+    uint8_t                 num_candidates;
+    mesh_time_election_candidate_t candidate[MESH_TIME_ELECTION_MAX_CANDIDATES];
+} mesh_time_election_t;
+
+typedef struct
+{
+    wiced_bool_t            enabled;                            // HCI frames are recorded
+    uint16_t                length;                             // Number of bytes used in the buffer
+    uint16_t                num_records;                        // Number of recorded frames
+    uint16_t                num_dropped;                        // Number of frames not recorded because the buffer was full
+    uint8_t                 buf[MESH_TIME_CAPTURE_BUF_SIZE];    // Header followed by the records
+} mesh_time_capture_t;
+
+typedef struct
+{
+    uint32_t                num_cmd;                            // Number of commands received from the host
+    uint32_t                num_retry;                          // Number of retransmissions
+    uint32_t                num_reply;                          // Number of statuses matched to the command
+    uint32_t                num_lost;                           // Number of commands not answered in time or superseded
+    uint16_t                rtt_hist[MESH_TIME_STATS_NUM_BUCKETS]; // Round trip histogram, log2 of milliseconds
+} mesh_time_opcode_stats_t;
+
+typedef struct
+{
+    uint16_t                addr;                               // Unicast address, 0 if the entry is free
+    uint8_t                 pending;                            // Bit N is set when status N is expected
+    uint8_t                 opcode_idx[MESH_TIME_STATS_NUM_STATUSES]; // Command waiting for status N
+    uint32_t                tx_ms[MESH_TIME_STATS_NUM_STATUSES];  // Arrival time of the command waiting for status N
+    uint32_t                num_cmd;                            // Number of commands sent to the destination
+    uint32_t                num_reply;                          // Number of statuses received from the destination
+    uint32_t                num_lost;                           // Number of commands not answered
+    uint16_t                srtt_ms;                            // Smoothed round trip time
+    uint16_t                max_rtt_ms;                         // Max round trip time
+} mesh_time_dst_stats_t;
+
+typedef struct
+{
+    uint32_t                num_unknown_event;                  // Events from the time client model not processed by the app
+    uint32_t                num_unknown_cmd;                    // HCI commands not processed by the app
+    uint32_t                num_bad_hdr;                        // HCI commands with invalid mesh header
+    uint32_t                num_unsolicited;                    // Statuses without command waiting for them
+    uint8_t                 next_dst;                           // Next destination entry to replace
+    mesh_time_opcode_stats_t opcode[MESH_TIME_STATS_NUM_OPCODES];
+    mesh_time_dst_stats_t   dst[MESH_TIME_STATS_NUM_DST];
+} mesh_time_stats_t;
+
+typedef struct
+{
+    wiced_transport_buffer_pool_t *p_pool;                      // HCI event buffers
+    uint8_t                 high_water;                         // Max number of buffers in use
+    uint32_t                num_alloc;                          // Number of HCI events allocated
+    uint32_t                num_alloc_fail;                     // Number of HCI events dropped because no buffer was available
+    uint32_t                num_cmd_alloc;                      // Number of mesh events created from HCI commands
+    uint32_t                num_cmd_alloc_fail;                 // Number of HCI commands dropped because the mesh event was not created
+} mesh_time_hci_event_pool_t;
 
 /******************************************************
  *          Function Prototypes
@@ -75,10 +549,128 @@ static void mesh_time_tai_utc_delta_get(wiced_bt_mesh_event_t *p_event, uint8_t
 static void mesh_time_tai_utc_delta_set(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length);
 static void mesh_time_role_get(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length);
 static void mesh_time_role_set(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length);
+static void mesh_time_get_batch(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length);
+static void mesh_time_command_index_init(void);
+static const mesh_time_command_t *mesh_time_command_find(uint16_t opcode);
+static wiced_bool_t mesh_time_command_process(const mesh_time_command_t *p_cmd, uint8_t *p_data, uint32_t length);
+static wiced_bool_t mesh_time_command_execute(const mesh_time_command_t *p_cmd, wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length);
+static void mesh_time_sync_scheduler_get(uint8_t *p_data, uint32_t length);
+static void mesh_time_now_get(uint8_t *p_data, uint32_t length);
+static void mesh_time_pool_stats_get(uint8_t *p_data, uint32_t length);
+static void mesh_time_stats_get(uint8_t *p_data, uint32_t length);
+static void mesh_time_pace_get(uint8_t *p_data, uint32_t length);
+static void mesh_time_election_get(uint8_t *p_data, uint32_t length);
+static void mesh_time_command_batch(uint8_t *p_data, uint32_t length);
+static wiced_bool_t mesh_time_command_batch_item(uint16_t opcode, uint8_t *p_data, uint32_t length);
+static wiced_bool_t mesh_time_pace_is_queued(uint32_t seq);
+static wiced_bool_t mesh_time_pace_send(const mesh_time_command_t *p_cmd, wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length);
+static void mesh_time_pace_transmit(const mesh_time_command_t *p_cmd, wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length);
+static mesh_time_pace_entry_t *mesh_time_pace_next(void);
+static void mesh_time_pace_run(wiced_bool_t jitter_done);
+static void mesh_time_pace_dequeue(void);
+static void mesh_time_pace_timeout(TIMER_PARAM_TYPE arg);
+static void mesh_time_pace_set(uint8_t *p_data, uint32_t length);
+static wiced_bt_mesh_event_t *mesh_time_event_copy(wiced_bt_mesh_event_t *p_hdr, uint16_t dst);
+static void mesh_time_election_start(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length);
+static void mesh_time_election_survey(void);
+static void mesh_time_election_timeout(TIMER_PARAM_TYPE arg);
+static void mesh_time_election_complete(void);
+static void mesh_time_election_role_set(uint16_t addr, uint8_t role);
+static void mesh_time_election_status_process(uint16_t event, uint16_t src, void *p_data);
+#if MESH_TIME_CLIENT_CAPTURE
+static void mesh_time_capture_set(uint8_t *p_data, uint32_t length);
+static void mesh_time_capture_get(uint8_t *p_data, uint32_t length);
+static void mesh_time_capture_write(uint8_t direction, uint16_t opcode, uint8_t *p_data, uint32_t length);
+#endif
+#if !LOW_POWER_NODE
+static void mesh_time_proxy_set(uint8_t *p_data, uint32_t length);
+static void mesh_time_proxy_get(uint8_t *p_data, uint32_t length);
+static void mesh_time_proxy_timeout(TIMER_PARAM_TYPE arg);
+static void mesh_time_proxy_update_send(mesh_time_proxy_lpn_t *p_lpn, uint32_t residency_ms);
+static void mesh_time_proxy_timer_restart(void);
+#endif
+#if LOW_POWER_NODE
+static wiced_bool_t mesh_time_lpn_defer(uint16_t opcode, wiced_bt_mesh_event_t *p_hdr, uint16_t dst, wiced_bool_t host);
+static void mesh_time_lpn_flush(TIMER_PARAM_TYPE arg);
+static void mesh_time_lpn_sleep(uint32_t max_sleep_duration);
+static void mesh_time_lpn_set(uint8_t *p_data, uint32_t length);
+static void mesh_time_lpn_get(uint8_t *p_data, uint32_t length);
+#endif
+static void mesh_time_get_cached(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length);
+static mesh_time_server_t *mesh_time_server_find(uint16_t addr, uint8_t create);
+static wiced_bool_t mesh_time_server_is_tracked(uint16_t addr);
+static void mesh_time_server_status_process(uint16_t event, uint16_t src, void *p_data);
+static uint64_t mesh_time_client_get_tick_ms(void);
+static void mesh_time_trace_drain(TIMER_PARAM_TYPE arg);
+static void mesh_time_request_send(wiced_bt_mesh_event_t *p_event, const mesh_time_command_t *p_cmd, uint8_t num_waiters);
+static wiced_bt_mesh_hci_event_t *mesh_time_hci_event_create(wiced_bt_mesh_event_t *p_event);
+static uint8_t mesh_time_stats_opcode_idx(uint16_t opcode);
+static uint8_t mesh_time_stats_status_idx(uint8_t opcode_idx);
+static mesh_time_dst_stats_t *mesh_time_stats_dst_find(uint16_t addr, wiced_bool_t create);
+static void mesh_time_stats_command(uint16_t opcode, wiced_bt_mesh_event_t *p_event);
+static void mesh_time_stats_status(uint16_t event, uint16_t src);
+static void mesh_time_stats_retry(uint16_t opcode);
+static void mesh_time_stats_timeout(uint16_t opcode, uint16_t dst);
+static void mesh_time_stats_reset(void);
+static void mesh_time_request_transmit(const mesh_time_command_t *p_cmd, wiced_bt_mesh_event_t *p_event);
+static uint8_t mesh_time_request_complete(uint16_t opcode, uint16_t src);
+static uint64_t mesh_time_request_tx_ms(uint16_t opcode, uint16_t src);
+static uint8_t mesh_time_request_num_free(void);
+static void mesh_time_request_timer_restart(void);
+static void mesh_time_request_timeout(TIMER_PARAM_TYPE arg);
+static void mesh_time_server_sample_add(mesh_time_server_t *p_server, uint64_t tx_ms, uint64_t rx_ms);
+static uint32_t mesh_time_server_score(mesh_time_server_t *p_server);
+static uint8_t mesh_time_server_ranking(mesh_time_server_t **p_ranking, uint8_t max_num);
+static mesh_time_server_t *mesh_time_server_best(void);
+static void mesh_time_server_ranking_get(uint8_t *p_data, uint32_t length);
+static void mesh_time_client_time_get_send(wiced_bt_mesh_event_t *p_hdr, uint16_t dst);
+static wiced_bool_t mesh_time_batch_ready(void);
+static wiced_bool_t mesh_time_batch_send_next(void);
+static void mesh_time_batch_resume(void);
+static void mesh_time_batch_request_timeout(uint16_t dst);
+static void mesh_time_sync_scheduler_set(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length);
+static void mesh_time_sync_start(wiced_bool_t poll_now);
+static void mesh_time_sync_timeout(TIMER_PARAM_TYPE arg);
+static void mesh_time_sync_status_process(mesh_time_server_t *p_server, uint64_t rx_ms);
+static void mesh_time_clock_update(mesh_time_server_t *p_server, uint64_t rx_ms);
+static void mesh_time_clock_status_update(mesh_time_server_t *p_server, uint64_t rx_ms);
+static int64_t mesh_time_clock_advance(uint64_t tick_ms);
+static int64_t mesh_time_clock_at(uint64_t tick_ms, int64_t *p_slew_us);
+static void mesh_time_transition_add(mesh_time_transition_t *p_schedule, uint8_t *p_num, uint64_t tai, uint16_t value);
+static uint16_t mesh_time_transition_value(mesh_time_transition_t *p_schedule, uint8_t num, uint64_t tai, uint16_t current);
+static void mesh_time_seconds_to_date(uint64_t seconds, mesh_time_day_cache_t *p_cache, mesh_time_client_date_t *p_date);
+static void mesh_time_local_time_get(uint8_t *p_data, uint32_t length);
+static wiced_bool_t mesh_time_batch_status_process(uint16_t src, wiced_bt_mesh_time_state_msg_t *p_time_status);
+static void mesh_time_batch_complete(void);
+static void mesh_time_batch_timeout(TIMER_PARAM_TYPE arg);
+static uint8_t *mesh_time_state_to_stream(uint8_t *p, wiced_bt_mesh_time_state_msg_t *p_time_status);
 static void mesh_time_status_hci_event_send(wiced_bt_mesh_hci_event_t *p_hci_event, wiced_bt_mesh_time_state_msg_t *p_time_status);
 static void mesh_time_zone_status_hci_event_send(wiced_bt_mesh_hci_event_t *p_hci_event, wiced_bt_mesh_time_zone_status_t *p_time_status);
 static void mesh_time_tai_utc_delta_status_hci_event_send(wiced_bt_mesh_hci_event_t *p_hci_event, wiced_bt_mesh_time_tai_utc_delta_status_t *p_time_delta_status);
 static void mesh_time_role_status_hci_event_send(wiced_bt_mesh_hci_event_t *p_hci_event, wiced_bt_mesh_time_role_msg_t *p_role_status);
+static void mesh_time_batch_status_hci_event_send(uint16_t first, uint16_t count);
+static void mesh_time_server_ranking_hci_event_send(mesh_time_server_t **p_ranking, uint8_t num);
+static void mesh_time_offset_status_hci_event_send(mesh_time_server_t *p_server);
+static void mesh_time_sync_scheduler_status_hci_event_send(uint8_t status);
+static void mesh_time_now_status_hci_event_send(void);
+static void mesh_time_local_time_status_hci_event_send(uint64_t tai_seconds);
+static wiced_bool_t mesh_time_trace_hci_event_send(void);
+static void mesh_time_request_timeout_hci_event_send(mesh_time_request_t *p_request);
+static void mesh_time_pool_stats_hci_event_send(void);
+static void mesh_time_stats_hci_event_send(void);
+static void mesh_time_dst_stats_hci_event_send(void);
+static void mesh_time_command_batch_status_hci_event_send(uint8_t num_cmd, uint8_t *p_ack, uint8_t *p_queued);
+static void mesh_time_pace_status_hci_event_send(void);
+static void mesh_time_election_status_hci_event_send(void);
+#if MESH_TIME_CLIENT_CAPTURE
+static void mesh_time_capture_data_hci_event_send(uint8_t *p_data, uint32_t length);
+#endif
+static void mesh_time_transport_send(uint16_t opcode, uint8_t *p_data, uint16_t length);
+#if LOW_POWER_NODE
+static void mesh_time_lpn_status_hci_event_send(void);
+#else
+static void mesh_time_proxy_status_hci_event_send(void);
+#endif
 
 
 /******************************************************
@@ -88,6 +680,98 @@ uint8_t mesh_mfr_name[WICED_BT_MESH_PROPERTY_LEN_DEVICE_MANUFACTURER_NAME] = { '
 uint8_t mesh_model_num[WICED_BT_MESH_PROPERTY_LEN_DEVICE_MODEL_NUMBER]     = { '1', '2', '3', '4', 0, 0, 0, 0 };
 uint8_t mesh_system_id[8]                                                  = { 0xbb, 0xb8, 0xa1, 0x80, 0x5f, 0x9f, 0x91, 0x71 };
 
+mesh_time_batch_t mesh_time_batch;
+mesh_time_server_t mesh_time_server[MESH_TIME_CLIENT_MAX_SERVERS];
+
+mesh_time_sync_t mesh_time_sync;
+mesh_time_clock_t mesh_time_clock;
+mesh_time_trace_t mesh_time_trace;
+mesh_time_request_pool_t mesh_time_request;
+mesh_time_pace_t mesh_time_pace;
+mesh_time_election_t mesh_time_election;
+#if MESH_TIME_CLIENT_CAPTURE
+mesh_time_capture_t mesh_time_capture;
+#endif
+#if LOW_POWER_NODE
+mesh_time_lpn_t mesh_time_lpn;
+#else
+mesh_time_proxy_t mesh_time_proxy;
+#endif
+mesh_time_hci_event_pool_t mesh_time_hci_event_pool;
+mesh_time_stats_t mesh_time_stats;
+
+// HCI commands with counters, index in the table is the index in mesh_time_stats.opcode
+static const uint16_t mesh_time_stats_opcode[MESH_TIME_STATS_NUM_OPCODES] =
+{
+    HCI_CONTROL_MESH_COMMAND_TIME_GET,
+    HCI_CONTROL_MESH_COMMAND_TIME_SET,
+    HCI_CONTROL_MESH_COMMAND_TIME_ZONE_GET,
+    HCI_CONTROL_MESH_COMMAND_TIME_ZONE_SET,
+    HCI_CONTROL_MESH_COMMAND_TIME_TAI_UTC_DELTA_GET,
+    HCI_CONTROL_MESH_COMMAND_TIME_TAI_UTC_DELTA_SET,
+    HCI_CONTROL_MESH_COMMAND_TIME_ROLE_GET,
+    HCI_CONTROL_MESH_COMMAND_TIME_ROLE_SET,
+};
+
+// HCI commands processed by the time client. The table drives dispatch and validation of the
+// commands received from the host and of the sub-commands of the command batch.
+static const mesh_time_command_t mesh_time_command_table[] =
+{
+    // Time model messages
+    { HCI_CONTROL_MESH_COMMAND_TIME_GET,                  MESH_TIME_COMMAND_FLAG_MESH_HDR | MESH_TIME_COMMAND_FLAG_REQUEST | MESH_TIME_COMMAND_FLAG_BATCH, 0,                                     mesh_time_get,                  NULL },
+    { HCI_CONTROL_MESH_COMMAND_TIME_SET,                  MESH_TIME_COMMAND_FLAG_MESH_HDR | MESH_TIME_COMMAND_FLAG_PACED | MESH_TIME_COMMAND_FLAG_BATCH,   MESH_TIME_SET_PARAM_LEN,               mesh_time_set,                  NULL },
+    { HCI_CONTROL_MESH_COMMAND_TIME_ZONE_GET,             MESH_TIME_COMMAND_FLAG_MESH_HDR | MESH_TIME_COMMAND_FLAG_REQUEST | MESH_TIME_COMMAND_FLAG_BATCH, 0,                                     mesh_time_zone_get,             NULL },
+    { HCI_CONTROL_MESH_COMMAND_TIME_ZONE_SET,             MESH_TIME_COMMAND_FLAG_MESH_HDR | MESH_TIME_COMMAND_FLAG_PACED | MESH_TIME_COMMAND_FLAG_BATCH,   MESH_TIME_ZONE_SET_PARAM_LEN,          mesh_time_zone_set,             NULL },
+    { HCI_CONTROL_MESH_COMMAND_TIME_TAI_UTC_DELTA_GET,    MESH_TIME_COMMAND_FLAG_MESH_HDR | MESH_TIME_COMMAND_FLAG_REQUEST | MESH_TIME_COMMAND_FLAG_BATCH, 0,                                     mesh_time_tai_utc_delta_get,    NULL },
+    { HCI_CONTROL_MESH_COMMAND_TIME_TAI_UTC_DELTA_SET,    MESH_TIME_COMMAND_FLAG_MESH_HDR | MESH_TIME_COMMAND_FLAG_PACED | MESH_TIME_COMMAND_FLAG_BATCH,   MESH_TIME_TAI_UTC_DELTA_SET_PARAM_LEN, mesh_time_tai_utc_delta_set,    NULL },
+    { HCI_CONTROL_MESH_COMMAND_TIME_ROLE_GET,             MESH_TIME_COMMAND_FLAG_MESH_HDR | MESH_TIME_COMMAND_FLAG_REQUEST | MESH_TIME_COMMAND_FLAG_BATCH, 0,                                     mesh_time_role_get,             NULL },
+    { HCI_CONTROL_MESH_COMMAND_TIME_ROLE_SET,             MESH_TIME_COMMAND_FLAG_MESH_HDR | MESH_TIME_COMMAND_FLAG_PACED | MESH_TIME_COMMAND_FLAG_BATCH,   MESH_TIME_ROLE_SET_PARAM_LEN,          mesh_time_role_set,             NULL },
+
+    // Commands with the mesh header providing the addressing parameters
+    { HCI_CONTROL_MESH_COMMAND_TIME_GET_BATCH,            MESH_TIME_COMMAND_FLAG_MESH_HDR,                                                                 MESH_TIME_GET_BATCH_PARAM_LEN,         mesh_time_get_batch,            NULL },
+    { HCI_CONTROL_MESH_COMMAND_TIME_GET_CACHED,           MESH_TIME_COMMAND_FLAG_MESH_HDR,                                                                 0,                                     mesh_time_get_cached,           NULL },
+    { HCI_CONTROL_MESH_COMMAND_TIME_SYNC_SCHEDULER_SET,   MESH_TIME_COMMAND_FLAG_MESH_HDR,                                                                 MESH_TIME_SYNC_SCHEDULER_SET_PARAM_LEN, mesh_time_sync_scheduler_set,  NULL },
+    { HCI_CONTROL_MESH_COMMAND_TIME_ELECTION_START,       MESH_TIME_COMMAND_FLAG_MESH_HDR,                                                                 MESH_TIME_ELECTION_START_PARAM_LEN,    mesh_time_election_start,       NULL },
+
+    // Commands handled locally
+    { HCI_CONTROL_MESH_COMMAND_TIME_SERVER_RANKING_GET,   0,                                                                                               0,                                     NULL, mesh_time_server_ranking_get },
+    { HCI_CONTROL_MESH_COMMAND_TIME_SYNC_SCHEDULER_GET,   0,                                                                                               0,                                     NULL, mesh_time_sync_scheduler_get },
+    { HCI_CONTROL_MESH_COMMAND_TIME_NOW_GET,              0,                                                                                               0,                                     NULL, mesh_time_now_get },
+    { HCI_CONTROL_MESH_COMMAND_LOCAL_TIME_GET,            0,                                                                                               0,                                     NULL, mesh_time_local_time_get },
+    { HCI_CONTROL_MESH_COMMAND_TIME_CLIENT_POOL_STATS_GET, 0,                                                                                              0,                                     NULL, mesh_time_pool_stats_get },
+    { HCI_CONTROL_MESH_COMMAND_TIME_CLIENT_STATS_GET,     0,                                                                                               0,                                     NULL, mesh_time_stats_get },
+    { HCI_CONTROL_MESH_COMMAND_TIME_COMMAND_BATCH,        0,                                                                                               0,                                     NULL, mesh_time_command_batch },
+    { HCI_CONTROL_MESH_COMMAND_TIME_PACING_SET,           0,                                                                                               MESH_TIME_PACING_SET_PARAM_LEN,        NULL, mesh_time_pace_set },
+    { HCI_CONTROL_MESH_COMMAND_TIME_PACING_GET,           0,                                                                                               0,                                     NULL, mesh_time_pace_get },
+    { HCI_CONTROL_MESH_COMMAND_TIME_ELECTION_GET,         0,                                                                                               0,                                     NULL, mesh_time_election_get },
+#if LOW_POWER_NODE
+    { HCI_CONTROL_MESH_COMMAND_TIME_LPN_SET,              0,                                                                                               MESH_TIME_LPN_SET_PARAM_LEN,           NULL, mesh_time_lpn_set },
+    { HCI_CONTROL_MESH_COMMAND_TIME_LPN_GET,              0,                                                                                               0,                                     NULL, mesh_time_lpn_get },
+#else
+    { HCI_CONTROL_MESH_COMMAND_TIME_PROXY_SET,            0,                                                                                               MESH_TIME_PROXY_SET_PARAM_LEN,         NULL, mesh_time_proxy_set },
+    { HCI_CONTROL_MESH_COMMAND_TIME_PROXY_GET,            0,                                                                                               0,                                     NULL, mesh_time_proxy_get },
+#endif
+#if MESH_TIME_CLIENT_CAPTURE
+    { HCI_CONTROL_MESH_COMMAND_TIME_CAPTURE_SET,          MESH_TIME_COMMAND_FLAG_NO_CAPTURE,                                                               MESH_TIME_CAPTURE_SET_PARAM_LEN,       NULL, mesh_time_capture_set },
+    { HCI_CONTROL_MESH_COMMAND_TIME_CAPTURE_GET,          MESH_TIME_COMMAND_FLAG_NO_CAPTURE,                                                               0,                                     NULL, mesh_time_capture_get },
+#endif
+};
+
+// Position + 1 of the command in mesh_time_command_table by the low byte of the opcode, 0 if
+// the command is not supported. All time client commands are in the HCI_CONTROL_GROUP_MESH group.
+uint8_t mesh_time_command_index[256];
+
+mesh_time_conversion_t mesh_time_conversion =
+{
+    .zone_offset   = MESH_TIME_ZONE_OFFSET_BIAS,
+    .tai_utc_delta = MESH_TIME_TAI_UTC_DELTA_BIAS,
+    .utc_day       = { .day_start = (uint64_t)-1 },
+    .local_day     = { .day_start = (uint64_t)-1 },
+};
+
+// Header used to create HCI events which are not related to a received mesh message
+wiced_bt_mesh_event_t mesh_time_client_local_hdr;
+
 wiced_bt_mesh_core_config_model_t   mesh_element1_models[] =
 {
     WICED_BT_MESH_DEVICE,
@@ -166,7 +850,11 @@ wiced_bt_mesh_app_func_table_t wiced_bt_mesh_app_func_table =
     NULL,                   // attention processing
     NULL,                   // notify period set
     mesh_app_proc_rx_cmd,   // WICED HCI command
+#if LOW_POWER_NODE
+    mesh_time_lpn_sleep,    // LPN sleep
+#else
     NULL,                   // LPN sleep
+#endif
     NULL                    // factory reset
 };
 
@@ -175,6 +863,9 @@ wiced_bt_mesh_app_func_table_t wiced_bt_mesh_app_func_table =
  ******************************************************/
 void mesh_app_init(wiced_bool_t is_provisioned)
 {
+    static wiced_bool_t timers_initialized = WICED_FALSE;
+    wiced_result_t result;
+
     wiced_bt_cfg_settings.device_name = (uint8_t *)"Time Client";
     wiced_bt_cfg_settings.gatt_cfg.appearance = APPEARANCE_GENERIC_TAG;
     // Adv Data is fixed. Spec allows to put URI, Name, Appearance and Tx Power in the Scan Response Data.
@@ -198,8 +889,43 @@ void mesh_app_init(wiced_bool_t is_provisioned)
         wiced_bt_mesh_set_raw_scan_response_data(num_elem, adv_elem);
     }
 
+    // Application init can be executed again when the device is provisioned
+    if (!timers_initialized)
+    {
+        wiced_init_timer(&mesh_time_batch.timer, mesh_time_batch_timeout, 0, WICED_SECONDS_TIMER);
+        wiced_init_timer(&mesh_time_sync.timer, mesh_time_sync_timeout, 0, WICED_SECONDS_TIMER);
+        wiced_init_timer(&mesh_time_trace.timer, mesh_time_trace_drain, 0, WICED_MILLI_SECONDS_TIMER);
+        wiced_init_timer(&mesh_time_request.timer, mesh_time_request_timeout, 0, WICED_MILLI_SECONDS_TIMER);
+        wiced_init_timer(&mesh_time_pace.timer, mesh_time_pace_timeout, 0, WICED_MILLI_SECONDS_TIMER);
+        wiced_init_timer(&mesh_time_election.timer, mesh_time_election_timeout, 0, WICED_SECONDS_TIMER);
+        mesh_time_pace.rate      = MESH_TIME_PACE_DEFAULT_RATE;
+        mesh_time_pace.burst     = MESH_TIME_PACE_DEFAULT_BURST;
+        mesh_time_pace.jitter_ms = MESH_TIME_PACE_DEFAULT_JITTER;
+        mesh_time_pace.tokens    = MESH_TIME_PACE_DEFAULT_BURST * 1000;
+#if LOW_POWER_NODE
+        wiced_init_timer(&mesh_time_lpn.timer, mesh_time_lpn_flush, 0, WICED_MILLI_SECONDS_TIMER);
+#else
+        wiced_init_timer(&mesh_time_proxy.timer, mesh_time_proxy_timeout, 0, WICED_MILLI_SECONDS_TIMER);
+#endif
+#ifdef HCI_CONTROL
+        mesh_time_hci_event_pool.p_pool = wiced_transport_create_buffer_pool(MESH_TIME_HCI_EVENT_POOL_BUF_SIZE, MESH_TIME_HCI_EVENT_POOL_COUNT);
+#endif
+        mesh_time_trace.initialized = WICED_TRUE;
+        mesh_time_command_index_init();
+        timers_initialized = WICED_TRUE;
+    }
+
     // register with the library to receive parsed data
     wiced_bt_mesh_model_time_client_init(mesh_time_client_message_handler, is_provisioned);
+
+    // Periodic time sync configured by the host survives the reset. The first poll is done from
+    // the timer, after the initialization of the application is complete.
+    if (is_provisioned &&
+        (wiced_hal_read_nvram(MESH_TIME_SYNC_CONFIG_NVRAM_ID, sizeof(mesh_time_sync.config), (uint8_t *)&mesh_time_sync.config, &result) == sizeof(mesh_time_sync.config)) &&
+        (result == WICED_SUCCESS) && mesh_time_sync.config.enabled)
+    {
+        mesh_time_sync_start(WICED_FALSE);
+    }
 }
 
 /*
@@ -209,41 +935,79 @@ void mesh_time_client_message_handler(uint16_t event, wiced_bt_mesh_event_t *p_e
 {
 #if defined HCI_CONTROL
     wiced_bt_mesh_hci_event_t *p_hci_event;
+    uint8_t num_reports;
+    uint8_t i;
+#endif
+    uint8_t num_waiters;
+
+    MESH_TIME_TRACE(DEBUG, MSG, event, 0, 0);
+
+    mesh_time_stats_status(event, p_event->src);
+#if LOW_POWER_NODE
+    if (event == WICED_BT_MESH_TIME_STATUS)
+        mesh_time_lpn.num_syncs++;
 #endif
-    WICED_BT_TRACE("time clt msg:%d\n", event);
+    mesh_time_server_status_process(event, p_event->src, p_data);
+    mesh_time_election_status_process(event, p_event->src, p_data);
 
+    // Each host request coalesced into the get receives the status
     switch (event)
     {
     case WICED_BT_MESH_TIME_STATUS:
+        num_waiters = mesh_time_request_complete(HCI_CONTROL_MESH_COMMAND_TIME_GET, p_event->src);
+
+        // Replies to a batch get are reported in one aggregated event
+        if (mesh_time_batch_status_process(p_event->src, (wiced_bt_mesh_time_state_msg_t *)p_data) && (num_waiters == 0))
+            break;
 #if defined HCI_CONTROL
-        if ((p_hci_event = wiced_bt_mesh_create_hci_event(p_event)) != NULL)
-            mesh_time_status_hci_event_send(p_hci_event, (wiced_bt_mesh_time_state_msg_t *)p_data);
+        num_reports = (num_waiters != 0) ? num_waiters : 1;
+        for (i = 0; i < num_reports; i++)
+        {
+            if ((p_hci_event = mesh_time_hci_event_create(p_event)) != NULL)
+                mesh_time_status_hci_event_send(p_hci_event, (wiced_bt_mesh_time_state_msg_t *)p_data);
+        }
 #endif
         break;
 
     case WICED_BT_MESH_TIME_ZONE_STATUS:
+        num_waiters = mesh_time_request_complete(HCI_CONTROL_MESH_COMMAND_TIME_ZONE_GET, p_event->src);
 #if defined HCI_CONTROL
-        if ((p_hci_event = wiced_bt_mesh_create_hci_event(p_event)) != NULL)
-            mesh_time_zone_status_hci_event_send(p_hci_event, (wiced_bt_mesh_time_zone_status_t *)p_data);
+        num_reports = (num_waiters != 0) ? num_waiters : 1;
+        for (i = 0; i < num_reports; i++)
+        {
+            if ((p_hci_event = mesh_time_hci_event_create(p_event)) != NULL)
+                mesh_time_zone_status_hci_event_send(p_hci_event, (wiced_bt_mesh_time_zone_status_t *)p_data);
+        }
 #endif
         break;
 
     case WICED_BT_MESH_TAI_UTC_DELTA_STATUS:
+        num_waiters = mesh_time_request_complete(HCI_CONTROL_MESH_COMMAND_TIME_TAI_UTC_DELTA_GET, p_event->src);
 #if defined HCI_CONTROL
-        if ((p_hci_event = wiced_bt_mesh_create_hci_event(p_event)) != NULL)
-            mesh_time_tai_utc_delta_status_hci_event_send(p_hci_event, (wiced_bt_mesh_time_tai_utc_delta_status_t *)p_data);
+        num_reports = (num_waiters != 0) ? num_waiters : 1;
+        for (i = 0; i < num_reports; i++)
+        {
+            if ((p_hci_event = mesh_time_hci_event_create(p_event)) != NULL)
+                mesh_time_tai_utc_delta_status_hci_event_send(p_hci_event, (wiced_bt_mesh_time_tai_utc_delta_status_t *)p_data);
+        }
 #endif
         break;
 
     case WICED_BT_MESH_TIME_ROLE_STATUS:
+        num_waiters = mesh_time_request_complete(HCI_CONTROL_MESH_COMMAND_TIME_ROLE_GET, p_event->src);
 #if defined HCI_CONTROL
-        if ((p_hci_event = wiced_bt_mesh_create_hci_event(p_event)) != NULL)
-            mesh_time_role_status_hci_event_send(p_hci_event, (wiced_bt_mesh_time_role_msg_t *)p_data);
+        num_reports = (num_waiters != 0) ? num_waiters : 1;
+        for (i = 0; i < num_reports; i++)
+        {
+            if ((p_hci_event = mesh_time_hci_event_create(p_event)) != NULL)
+                mesh_time_role_status_hci_event_send(p_hci_event, (wiced_bt_mesh_time_role_msg_t *)p_data);
+        }
 #endif
         break;
 
     default:
-        WICED_BT_TRACE("unknown\n");
+        MESH_TIME_TRACE(ERROR, UNKNOWN_EVENT, event, 0, 0);
+        mesh_time_stats.num_unknown_event++;
         break;
     }
     wiced_bt_mesh_release_event(p_event);
@@ -254,196 +1018,2844 @@ void mesh_time_client_message_handler(uint16_t event, wiced_bt_mesh_event_t *p_e
  */
 uint32_t mesh_app_proc_rx_cmd(uint16_t opcode, uint8_t *p_data, uint32_t length)
 {
-    wiced_bt_mesh_event_t *p_event;
-
-    WICED_BT_TRACE("[%s] cmd_opcode 0x%02x\n", __FUNCTION__, opcode);
-
-    switch (opcode)
-    {
-    case HCI_CONTROL_MESH_COMMAND_TIME_GET:
-    case HCI_CONTROL_MESH_COMMAND_TIME_SET:
-    case HCI_CONTROL_MESH_COMMAND_TIME_ZONE_GET:
-    case HCI_CONTROL_MESH_COMMAND_TIME_ZONE_SET:
-    case HCI_CONTROL_MESH_COMMAND_TIME_TAI_UTC_DELTA_GET:
-    case HCI_CONTROL_MESH_COMMAND_TIME_TAI_UTC_DELTA_SET:
-    case HCI_CONTROL_MESH_COMMAND_TIME_ROLE_GET:
-    case HCI_CONTROL_MESH_COMMAND_TIME_ROLE_SET:
-        break;
-
-    default:
-        WICED_BT_TRACE("unknown\n");
-        return WICED_FALSE;
-    }
-    p_event = wiced_bt_mesh_create_event_from_wiced_hci(opcode, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_TIME_CLNT, &p_data, &length);
-    if (p_event == NULL)
-    {
-        WICED_BT_TRACE("bad hdr\n");
-        return WICED_TRUE;
-    }
-    switch (opcode)
-    {
-    case HCI_CONTROL_MESH_COMMAND_TIME_GET:
-        mesh_time_get(p_event, p_data, length);
-        break;
-
-    case HCI_CONTROL_MESH_COMMAND_TIME_SET:
-        mesh_time_set(p_event, p_data, length);
-        break;
-
-    case HCI_CONTROL_MESH_COMMAND_TIME_ZONE_GET:
-        mesh_time_zone_get(p_event, p_data, length);
-        break;
-
-    case HCI_CONTROL_MESH_COMMAND_TIME_ZONE_SET:
-        mesh_time_zone_set(p_event, p_data, length);
-        break;
+    const mesh_time_command_t *p_cmd;
 
-    case HCI_CONTROL_MESH_COMMAND_TIME_TAI_UTC_DELTA_GET:
-        mesh_time_tai_utc_delta_get(p_event, p_data, length);
-        break;
+    MESH_TIME_TRACE(DEBUG, CMD, opcode, 0, 0);
 
-    case HCI_CONTROL_MESH_COMMAND_TIME_TAI_UTC_DELTA_SET:
-        mesh_time_tai_utc_delta_set(p_event, p_data, length);
-        break;
+    p_cmd = mesh_time_command_find(opcode);
 
-    case HCI_CONTROL_MESH_COMMAND_TIME_ROLE_GET:
-        mesh_time_role_get(p_event, p_data, length);
-        break;
+#if MESH_TIME_CLIENT_CAPTURE
+    if ((p_cmd == NULL) || !(p_cmd->flags & MESH_TIME_COMMAND_FLAG_NO_CAPTURE))
+        mesh_time_capture_write(MESH_TIME_CAPTURE_DIR_COMMAND, opcode, p_data, length);
+#endif
 
-    case HCI_CONTROL_MESH_COMMAND_TIME_ROLE_SET:
-        mesh_time_role_set(p_event, p_data, length);
-        break;
+    if (p_cmd == NULL)
+    {
+        MESH_TIME_TRACE(ERROR, UNKNOWN_CMD, opcode, 0, 0);
+        mesh_time_stats.num_unknown_cmd++;
+        return WICED_FALSE;
     }
+    mesh_time_command_process(p_cmd, p_data, length);
     return WICED_TRUE;
 }
 
 /*
- * Send time get command
+ * Build the index of the command table by the low byte of the opcode. A command outside of the
+ * mesh group or with the low byte of an earlier command could not be found, it is reported and
+ * the earlier command is kept.
  */
-void mesh_time_get(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length)
+void mesh_time_command_index_init(void)
 {
-    WICED_BT_TRACE("mesh_time_get\n");
-    wiced_bt_mesh_model_time_client_time_get_send(p_event);
+    uint16_t opcode;
+    uint8_t  idx;
+    uint8_t  i;
+
+    memset(mesh_time_command_index, 0, sizeof(mesh_time_command_index));
+    for (i = 0; i < sizeof(mesh_time_command_table) / sizeof(mesh_time_command_table[0]); i++)
+    {
+        opcode = mesh_time_command_table[i].opcode;
+        idx    = mesh_time_command_index[opcode & 0xFF];
+        if (((opcode >> 8) != HCI_CONTROL_GROUP_MESH) || (idx != 0))
+        {
+            MESH_TIME_TRACE(ERROR, CMD_DUPLICATE, opcode, (idx != 0) ? mesh_time_command_table[idx - 1].opcode : 0, i);
+            continue;
+        }
+        mesh_time_command_index[opcode & 0xFF] = i + 1;
+    }
 }
 
 /*
- * Send time set command
+ * Find the descriptor of the HCI command. Returns NULL if the command is not supported.
  */
-void mesh_time_set(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length)
+const mesh_time_command_t *mesh_time_command_find(uint16_t opcode)
 {
-    wiced_bt_mesh_time_state_msg_t set_data;
+    uint8_t idx;
 
-    WICED_BT_TRACE("mesh_time_set\n");
+    if ((opcode >> 8) != HCI_CONTROL_GROUP_MESH)
+        return NULL;
 
-    STREAM_TO_UINT40(set_data.tai_seconds, p_data);
-    STREAM_TO_UINT8(set_data.subsecond, p_data);
-    STREAM_TO_UINT8(set_data.uncertainty, p_data);
-    STREAM_TO_UINT8(set_data.time_authority, p_data);
-    STREAM_TO_UINT16(set_data.tai_utc_delta_current, p_data);
-    STREAM_TO_UINT8(set_data.time_zone_offset_current, p_data);
-
-    wiced_bt_mesh_model_time_client_time_set_send(p_event, &set_data);
+    idx = mesh_time_command_index[opcode & 0xFF];
+    return (idx != 0) ? &mesh_time_command_table[idx - 1] : NULL;
 }
 
 /*
- * Send time zone get command
+ * Validate and execute the HCI command. The mesh header is parsed if the command has one, and
+ * the handler is called only if the remaining data contains all parameters, so the handlers can
+ * read the fixed parameters without checking the length. Gets are sent through the request
+ * tracker, sets through the pacing queue. Returns WICED_FALSE if the command is not executed.
  */
-void mesh_time_zone_get(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length)
+wiced_bool_t mesh_time_command_process(const mesh_time_command_t *p_cmd, uint8_t *p_data, uint32_t length)
 {
-    WICED_BT_TRACE("mesh_time_zone_get\n");
+    wiced_bt_mesh_event_t *p_event;
 
-    wiced_bt_mesh_model_time_client_time_zone_get_send(p_event);
+    if (!(p_cmd->flags & MESH_TIME_COMMAND_FLAG_MESH_HDR))
+    {
+        if (length < p_cmd->param_len)
+        {
+            MESH_TIME_TRACE(ERROR, BAD_LEN, p_cmd->opcode, length, p_cmd->param_len);
+            return WICED_FALSE;
+        }
+        p_cmd->p_local_handler(p_data, length);
+        return WICED_TRUE;
+    }
+    p_event = wiced_bt_mesh_create_event_from_wiced_hci(p_cmd->opcode, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_TIME_CLNT, &p_data, &length);
+    if (p_event == NULL)
+    {
+        MESH_TIME_TRACE(ERROR, BAD_HDR, p_cmd->opcode, 0, 0);
+        mesh_time_hci_event_pool.num_cmd_alloc_fail++;
+        mesh_time_stats.num_bad_hdr++;
+        return WICED_FALSE;
+    }
+    mesh_time_hci_event_pool.num_cmd_alloc++;
+
+    return mesh_time_command_execute(p_cmd, p_event, p_data, length);
 }
 
 /*
- * Send time zone set command
+ * Execute the command with the mesh event created from the header. The event is released or
+ * passed to the model. Returns WICED_FALSE if the parameters are too short or the message is
+ * dropped.
  */
-void mesh_time_zone_set(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length)
+wiced_bool_t mesh_time_command_execute(const mesh_time_command_t *p_cmd, wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length)
 {
-    wiced_bt_mesh_time_zone_set_t set_data;
-
-    WICED_BT_TRACE("mesh_time_zone_set\n");
-
-    STREAM_TO_UINT8(set_data.time_zone_offset_new, p_data);
-    STREAM_TO_UINT40(set_data.tai_of_zone_change, p_data);
+    if (length < p_cmd->param_len)
+    {
+        MESH_TIME_TRACE(ERROR, BAD_LEN, p_cmd->opcode, length, p_cmd->param_len);
+        wiced_bt_mesh_release_event(p_event);
+        return WICED_FALSE;
+    }
+    mesh_time_stats_command(p_cmd->opcode, p_event);
 
-    wiced_bt_mesh_model_time_client_time_zone_set_send(p_event, &set_data);
+    if (p_cmd->flags & MESH_TIME_COMMAND_FLAG_REQUEST)
+    {
+#if LOW_POWER_NODE
+        if (mesh_time_lpn_defer(p_cmd->opcode, p_event, p_event->dst, WICED_TRUE))
+        {
+            wiced_bt_mesh_release_event(p_event);
+            return WICED_TRUE;
+        }
+#endif
+        mesh_time_request_send(p_event, p_cmd, 1);
+    }
+    // Set messages can be sent to many nodes in a burst and go through the pacing queue
+    else if (p_cmd->flags & MESH_TIME_COMMAND_FLAG_PACED)
+    {
+        return mesh_time_pace_send(p_cmd, p_event, p_data, length);
+    }
+    else
+    {
+        p_cmd->p_mesh_handler(p_event, p_data, length);
+    }
+    return WICED_TRUE;
 }
 
 /*
- * Send time tai_utc delta get command
+ * Report periodic time sync configuration and state
  */
-void mesh_time_tai_utc_delta_get(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t data_len)
+void mesh_time_sync_scheduler_get(uint8_t *p_data, uint32_t length)
 {
-    WICED_BT_TRACE("mesh_time_tai_utc_delta_get\n");
-
-    wiced_bt_mesh_model_time_client_tai_utc_delta_get_send(p_event);
+#ifdef HCI_CONTROL
+    mesh_time_sync_scheduler_status_hci_event_send(MESH_TIME_STATUS_SUCCESS);
+#endif
 }
 
 /*
- * Send time tai_utc delta set command
+ * Report current time of the local clock
  */
-void mesh_time_tai_utc_delta_set(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length)
+void mesh_time_now_get(uint8_t *p_data, uint32_t length)
 {
-    wiced_bt_mesh_time_tai_utc_delta_set_t set_data;
-
-    WICED_BT_TRACE("mesh_time_tai_utc_delta_set\n");
-
-    STREAM_TO_UINT16(set_data.tai_utc_delta_new, p_data);
-    STREAM_TO_UINT40(set_data.tai_of_delta_change, p_data);
-
-    wiced_bt_mesh_model_time_client_tai_utc_delta_set_send(p_event, &set_data);
+#ifdef HCI_CONTROL
+    mesh_time_now_status_hci_event_send();
+#endif
 }
 
 /*
- * Send time role get command
+ * Report allocation statistics. Statistics are reset if the host sets the reset flag.
  */
-void mesh_time_role_get(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length)
+void mesh_time_pool_stats_get(uint8_t *p_data, uint32_t length)
 {
-    WICED_BT_TRACE("mesh_time_role_get\n");
-
-    wiced_bt_mesh_model_time_client_time_role_get_send(p_event);
+#ifdef HCI_CONTROL
+    mesh_time_pool_stats_hci_event_send();
+#endif
+    if ((length >= 1) && (p_data[0] != 0))
+    {
+        mesh_time_hci_event_pool.high_water         = 0;
+        mesh_time_hci_event_pool.num_alloc          = 0;
+        mesh_time_hci_event_pool.num_alloc_fail     = 0;
+        mesh_time_hci_event_pool.num_cmd_alloc      = 0;
+        mesh_time_hci_event_pool.num_cmd_alloc_fail = 0;
+        mesh_time_request.high_water                = 0;
+        mesh_time_request.num_untracked             = 0;
+    }
 }
 
 /*
- * Send time role set command
+ * Report message statistics. Statistics are reset if the host sets the reset flag.
  */
-void mesh_time_role_set(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length)
+void mesh_time_stats_get(uint8_t *p_data, uint32_t length)
 {
-    wiced_bt_mesh_time_role_msg_t set_data;
-
-    WICED_BT_TRACE("mesh_time_role_set\n");
-
-    STREAM_TO_UINT8(set_data.role, p_data);
-
-    wiced_bt_mesh_model_time_client_time_role_set_send(p_event, &set_data);
+#ifdef HCI_CONTROL
+    mesh_time_stats_hci_event_send();
+    mesh_time_dst_stats_hci_event_send();
+#endif
+    if ((length >= 1) && (p_data[0] != 0))
+        mesh_time_stats_reset();
 }
 
-#ifdef HCI_CONTROL
 /*
- * Send Time Status event over transport
+ * Report pacing configuration and queue statistics. Statistics are reset if the host sets
+ * the reset flag.
  */
-void mesh_time_status_hci_event_send(wiced_bt_mesh_hci_event_t *p_hci_event, wiced_bt_mesh_time_state_msg_t *p_time_status)
+void mesh_time_pace_get(uint8_t *p_data, uint32_t length)
 {
-    uint8_t *p = p_hci_event->data;
-
-    WICED_BT_TRACE("%s\n", __FUNCTION__);
+#ifdef HCI_CONTROL
+    mesh_time_pace_status_hci_event_send();
+#endif
+    if ((length >= 1) && (p_data[0] != 0))
+    {
+        mesh_time_pace.high_water  = mesh_time_pace.depth;
+        mesh_time_pace.num_queued  = 0;
+        mesh_time_pace.num_sent    = 0;
+        mesh_time_pace.num_dropped = 0;
+    }
+}
+
+/*
+ * Report result of the last election
+ */
+void mesh_time_election_get(uint8_t *p_data, uint32_t length)
+{
+#ifdef HCI_CONTROL
+    mesh_time_election_status_hci_event_send();
+#endif
+}
+
+#if LOW_POWER_NODE
+/*
+ * Report Low Power Node energy statistics. Statistics are reset if the host sets the reset flag.
+ */
+void mesh_time_lpn_get(uint8_t *p_data, uint32_t length)
+{
+#ifdef HCI_CONTROL
+    mesh_time_lpn_status_hci_event_send();
+#endif
+    if ((length >= 1) && (p_data[0] != 0))
+    {
+        mesh_time_lpn.num_sleep      = 0;
+        mesh_time_lpn.num_deferred   = 0;
+        mesh_time_lpn.num_tx_wakeups = 0;
+        mesh_time_lpn.num_syncs      = 0;
+        mesh_time_lpn.on_time_ms     = 0;
+    }
+}
+#else
+/*
+ * Report configuration and counters of the time updates to the Low Power Nodes
+ */
+void mesh_time_proxy_get(uint8_t *p_data, uint32_t length)
+{
+#ifdef HCI_CONTROL
+    mesh_time_proxy_status_hci_event_send();
+#endif
+}
+#endif
+
+#if MESH_TIME_CLIENT_CAPTURE
+/*
+ * Send block of the capture buffer at the offset provided by the host
+ */
+void mesh_time_capture_get(uint8_t *p_data, uint32_t length)
+{
+#ifdef HCI_CONTROL
+    mesh_time_capture_data_hci_event_send(p_data, length);
+#endif
+}
+#endif
+
+/*
+ * Queue set message to be sent at the configured rate. The header is copied and the event is
+ * released, a new event is created when the message is sent. Returns WICED_FALSE if the queue
+ * is full and the message is dropped.
+ */
+wiced_bool_t mesh_time_pace_send(const mesh_time_command_t *p_cmd, wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length)
+{
+    mesh_time_pace_entry_t *p_entry = NULL;
+    int i;
+
+    if (mesh_time_pace.rate == 0)
+    {
+        mesh_time_pace_transmit(p_cmd, p_event, p_data, length);
+        return WICED_TRUE;
+    }
+    for (i = 0; i < MESH_TIME_PACE_QUEUE_SIZE; i++)
+    {
+        if (mesh_time_pace.entry[i].opcode == 0)
+        {
+            p_entry = &mesh_time_pace.entry[i];
+            break;
+        }
+    }
+    if (p_entry == NULL)
+    {
+        MESH_TIME_TRACE(ERROR, PACE_DROP, p_cmd->opcode, p_event->dst, mesh_time_pace.num_dropped);
+        mesh_time_pace.num_dropped++;
+        wiced_bt_mesh_release_event(p_event);
+        return WICED_FALSE;
+    }
+    if (length > MESH_TIME_SET_PARAM_LEN)
+        length = MESH_TIME_SET_PARAM_LEN;
+
+    memset(p_entry->param, 0, sizeof(p_entry->param));
+    memcpy(p_entry->param, p_data, length);
+    memcpy(&p_entry->hdr, p_event, sizeof(wiced_bt_mesh_event_t));
+    p_entry->opcode    = p_cmd->opcode;
+    p_entry->p_cmd     = p_cmd;
+    p_entry->param_len = (uint8_t)length;
+    p_entry->seq       = mesh_time_pace.seq++;
+    wiced_bt_mesh_release_event(p_event);
+
+    mesh_time_pace.num_queued++;
+    if (++mesh_time_pace.depth > mesh_time_pace.high_water)
+        mesh_time_pace.high_water = mesh_time_pace.depth;
+
+    mesh_time_pace_run(WICED_FALSE);
+    return WICED_TRUE;
+}
+
+/*
+ * Returns WICED_TRUE if the message queued with the sequence number is still waiting in the queue
+ */
+wiced_bool_t mesh_time_pace_is_queued(uint32_t seq)
+{
+    int i;
+
+    if (seq == mesh_time_pace.seq)
+        return WICED_FALSE;
+
+    for (i = 0; i < MESH_TIME_PACE_QUEUE_SIZE; i++)
+    {
+        if ((mesh_time_pace.entry[i].opcode != 0) && (mesh_time_pace.entry[i].seq == seq))
+            return WICED_TRUE;
+    }
+    return WICED_FALSE;
+}
+
+/*
+ * Send set message corresponding to the HCI command
+ */
+void mesh_time_pace_transmit(const mesh_time_command_t *p_cmd, wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length)
+{
+    p_cmd->p_mesh_handler(p_event, p_data, length);
+}
+
+/*
+ * Select the next message to send. Destinations are served in round robin order of the
+ * address starting after the last served one, messages to the same destination in the
+ * order of arrival. A burst to one node does not delay the messages to the other nodes.
+ */
+mesh_time_pace_entry_t *mesh_time_pace_next(void)
+{
+    mesh_time_pace_entry_t *p_entry;
+    mesh_time_pace_entry_t *p_next = NULL;
+    uint16_t distance;
+    uint16_t next_distance = 0;
+    int i;
+
+    for (i = 0; i < MESH_TIME_PACE_QUEUE_SIZE; i++)
+    {
+        p_entry = &mesh_time_pace.entry[i];
+        if (p_entry->opcode == 0)
+            continue;
+
+        // Last served destination has the largest distance
+        distance = (uint16_t)(p_entry->hdr.dst - mesh_time_pace.last_dst - 1);
+        if ((p_next == NULL) || (distance < next_distance) ||
+            ((distance == next_distance) && ((int32_t)(p_entry->seq - p_next->seq) < 0)))
+        {
+            p_next = p_entry;
+            next_distance = distance;
+        }
+    }
+    return p_next;
+}
+
+/*
+ * Send queued messages while tokens are available. Each message is delayed by a random
+ * time up to the configured jitter, so that nodes receiving a group set from several
+ * clients do not collide. The timer is started when the bucket is empty. Gets of the batch
+ * share the tokens and are sent when no set message is waiting and the request tracker has a
+ * free entry.
+ */
+void mesh_time_pace_run(wiced_bool_t jitter_done)
+{
+    uint64_t now;
+    uint32_t max_tokens;
+    uint32_t elapsed;
+    uint32_t delay;
+
+    if (mesh_time_pace.timer_running)
+        return;
+
+    while ((mesh_time_pace.depth != 0) || mesh_time_batch_ready())
+    {
+        // Refill the bucket for the time elapsed since the last refill
+        now = mesh_time_client_get_tick_ms();
+        max_tokens = (uint32_t)mesh_time_pace.burst * 1000;
+        elapsed = (now - mesh_time_pace.refill_ms < max_tokens) ? (uint32_t)(now - mesh_time_pace.refill_ms) : max_tokens;
+        mesh_time_pace.tokens += elapsed * mesh_time_pace.rate;
+        if (mesh_time_pace.tokens > max_tokens)
+            mesh_time_pace.tokens = max_tokens;
+        mesh_time_pace.refill_ms = now;
+
+        if (mesh_time_pace.tokens < 1000)
+        {
+            delay = (1000 - mesh_time_pace.tokens + mesh_time_pace.rate - 1) / mesh_time_pace.rate;
+            mesh_time_pace.jitter_wait = WICED_FALSE;
+        }
+        else if (!jitter_done && (mesh_time_pace.jitter_ms != 0))
+        {
+            delay = wiced_hal_rand_gen_num() % (mesh_time_pace.jitter_ms + 1);
+            mesh_time_pace.jitter_wait = WICED_TRUE;
+        }
+        else
+        {
+            delay = 0;
+        }
+        if (delay != 0)
+        {
+            mesh_time_pace.timer_running = WICED_TRUE;
+            wiced_start_timer(&mesh_time_pace.timer, delay);
+            return;
+        }
+        jitter_done = WICED_FALSE;
+        mesh_time_pace.tokens -= 1000;
+        if (mesh_time_pace.depth != 0)
+            mesh_time_pace_dequeue();
+        else
+            mesh_time_batch_send_next();
+    }
+}
+
+/*
+ * Remove the next message from the queue and send it
+ */
+void mesh_time_pace_dequeue(void)
+{
+    mesh_time_pace_entry_t *p_entry = mesh_time_pace_next();
+    wiced_bt_mesh_event_t  *p_event;
+
+    if (p_entry == NULL)
+        return;
+
+    mesh_time_pace.depth--;
+    mesh_time_pace.last_dst = p_entry->hdr.dst;
+
+    p_event = mesh_time_event_copy(&p_entry->hdr, p_entry->hdr.dst);
+    if (p_event == NULL)
+    {
+        MESH_TIME_TRACE(ERROR, NO_MEM, p_entry->opcode, p_entry->hdr.dst, 0);
+        mesh_time_pace.num_dropped++;
+        p_entry->opcode = 0;
+        return;
+    }
+
+    mesh_time_pace.num_sent++;
+    mesh_time_pace_transmit(p_entry->p_cmd, p_event, p_entry->param, p_entry->param_len);
+    p_entry->opcode = 0;
+}
+
+/*
+ * Pacing timer expired, the bucket has a token or the random delay is over
+ */
+void mesh_time_pace_timeout(TIMER_PARAM_TYPE arg)
+{
+    mesh_time_pace.timer_running = WICED_FALSE;
+    mesh_time_pace_run(mesh_time_pace.jitter_wait);
+}
+
+/*
+ * Configure pacing of the set messages. The data contains the rate in messages per second
+ * (0 to send without pacing), the max burst and the max random delay in milliseconds (2 bytes).
+ * Messages and batch gets waiting in the queue are sent immediately if pacing is disabled.
+ */
+void mesh_time_pace_set(uint8_t *p_data, uint32_t length)
+{
+    STREAM_TO_UINT8(mesh_time_pace.rate, p_data);
+    STREAM_TO_UINT8(mesh_time_pace.burst, p_data);
+    STREAM_TO_UINT16(mesh_time_pace.jitter_ms, p_data);
+
+    if (mesh_time_pace.burst == 0)
+        mesh_time_pace.burst = 1;
+
+    MESH_TIME_TRACE(INFO, PACE_CONFIG, mesh_time_pace.rate, mesh_time_pace.burst, mesh_time_pace.jitter_ms);
+
+    wiced_stop_timer(&mesh_time_pace.timer);
+    mesh_time_pace.timer_running = WICED_FALSE;
+
+    if (mesh_time_pace.rate == 0)
+    {
+        while (mesh_time_pace.depth != 0)
+            mesh_time_pace_dequeue();
+        mesh_time_batch_resume();
+    }
+    else
+    {
+        if (mesh_time_pace.tokens > (uint32_t)mesh_time_pace.burst * 1000)
+            mesh_time_pace.tokens = (uint32_t)mesh_time_pace.burst * 1000;
+        mesh_time_pace_run(WICED_FALSE);
+    }
+#ifdef HCI_CONTROL
+    mesh_time_pace_status_hci_event_send();
+#endif
+}
+
+/*
+ * Send a sequence of time commands received in one HCI frame. Each sub-command contains the
+ * opcode (2 bytes), the length (1 byte) and the same data as the standalone command, the mesh
+ * header followed by the parameters. Sub-commands are processed in order, the result is reported
+ * in HCI_CONTROL_MESH_EVENT_TIME_COMMAND_BATCH_STATUS with bit N of the first bitmap set if
+ * sub-command N has been sent and bit N of the second one set if it waits in the pacing queue.
+ */
+void mesh_time_command_batch(uint8_t *p_data, uint32_t length)
+{
+    uint8_t  ack[MESH_TIME_COMMAND_BATCH_MAX / 8];
+    uint8_t  queued[MESH_TIME_COMMAND_BATCH_MAX / 8];
+    uint8_t  num_cmd = 0;
+    uint8_t  num_ack = 0;
+    uint8_t  num_queued = 0;
+    uint16_t sub_opcode;
+    uint8_t  sub_len;
+    uint32_t seq;
+
+    memset(ack, 0, sizeof(ack));
+    memset(queued, 0, sizeof(queued));
+
+    while ((length >= 3) && (num_cmd < MESH_TIME_COMMAND_BATCH_MAX))
+    {
+        STREAM_TO_UINT16(sub_opcode, p_data);
+        STREAM_TO_UINT8(sub_len, p_data);
+        length -= 3;
+
+        // Truncated sub-command ends the batch
+        if (sub_len > length)
+        {
+            MESH_TIME_TRACE(ERROR, BAD_LEN, sub_opcode, sub_len, length);
+            num_cmd++;
+            break;
+        }
+        seq = mesh_time_pace.seq;
+        if (mesh_time_command_batch_item(sub_opcode, p_data, sub_len))
+        {
+            if (mesh_time_pace_is_queued(seq))
+            {
+                queued[num_cmd / 8] |= (1 << (num_cmd % 8));
+                num_queued++;
+            }
+            else
+            {
+                ack[num_cmd / 8] |= (1 << (num_cmd % 8));
+                num_ack++;
+            }
+        }
+        p_data += sub_len;
+        length -= sub_len;
+        num_cmd++;
+    }
+    MESH_TIME_TRACE(INFO, COMMAND_BATCH, num_cmd, num_ack, num_queued);
+
+#ifdef HCI_CONTROL
+    mesh_time_command_batch_status_hci_event_send(num_cmd, ack, queued);
+#endif
+}
+
+/*
+ * Send one sub-command of the batch. Returns WICED_FALSE if the opcode is not a time get or set,
+ * the mesh header is not valid or the parameters are too short.
+ */
+wiced_bool_t mesh_time_command_batch_item(uint16_t opcode, uint8_t *p_data, uint32_t length)
+{
+    const mesh_time_command_t *p_cmd = mesh_time_command_find(opcode);
+
+    if ((p_cmd == NULL) || !(p_cmd->flags & MESH_TIME_COMMAND_FLAG_BATCH))
+    {
+        MESH_TIME_TRACE(ERROR, UNKNOWN_CMD, opcode, 0, 0);
+        mesh_time_stats.num_unknown_cmd++;
+        return WICED_FALSE;
+    }
+    return mesh_time_command_process(p_cmd, p_data, length);
+}
+
+/*
+ * Send time get command
+ */
+void mesh_time_get(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length)
+{
+    MESH_TIME_TRACE(DEBUG, TIME_GET, p_event->dst, 0, 0);
+    wiced_bt_mesh_model_time_client_time_get_send(p_event);
+}
+
+/*
+ * Send time set command
+ */
+void mesh_time_set(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length)
+{
+    wiced_bt_mesh_time_state_msg_t set_data;
+
+    STREAM_TO_UINT40(set_data.tai_seconds, p_data);
+    STREAM_TO_UINT8(set_data.subsecond, p_data);
+    STREAM_TO_UINT8(set_data.uncertainty, p_data);
+    STREAM_TO_UINT8(set_data.time_authority, p_data);
+    STREAM_TO_UINT16(set_data.tai_utc_delta_current, p_data);
+    STREAM_TO_UINT8(set_data.time_zone_offset_current, p_data);
+
+    MESH_TIME_TRACE(INFO, TIME_SET, p_event->dst, set_data.tai_seconds, 0);
+
+    wiced_bt_mesh_model_time_client_time_set_send(p_event, &set_data);
+}
+
+/*
+ * Send time zone get command
+ */
+void mesh_time_zone_get(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length)
+{
+    MESH_TIME_TRACE(DEBUG, ZONE_GET, p_event->dst, 0, 0);
+
+    wiced_bt_mesh_model_time_client_time_zone_get_send(p_event);
+}
+
+/*
+ * Send time zone set command
+ */
+void mesh_time_zone_set(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length)
+{
+    wiced_bt_mesh_time_zone_set_t set_data;
+
+    STREAM_TO_UINT8(set_data.time_zone_offset_new, p_data);
+    STREAM_TO_UINT40(set_data.tai_of_zone_change, p_data);
+
+    MESH_TIME_TRACE(INFO, ZONE_SET, p_event->dst, set_data.time_zone_offset_new, set_data.tai_of_zone_change);
+
+    wiced_bt_mesh_model_time_client_time_zone_set_send(p_event, &set_data);
+}
+
+/*
+ * Send time tai_utc delta get command
+ */
+void mesh_time_tai_utc_delta_get(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t data_len)
+{
+    MESH_TIME_TRACE(DEBUG, DELTA_GET, p_event->dst, 0, 0);
+
+    wiced_bt_mesh_model_time_client_tai_utc_delta_get_send(p_event);
+}
+
+/*
+ * Send time tai_utc delta set command
+ */
+void mesh_time_tai_utc_delta_set(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length)
+{
+    wiced_bt_mesh_time_tai_utc_delta_set_t set_data;
+
+    STREAM_TO_UINT16(set_data.tai_utc_delta_new, p_data);
+    STREAM_TO_UINT40(set_data.tai_of_delta_change, p_data);
+
+    MESH_TIME_TRACE(INFO, DELTA_SET, p_event->dst, set_data.tai_utc_delta_new, set_data.tai_of_delta_change);
+
+    wiced_bt_mesh_model_time_client_tai_utc_delta_set_send(p_event, &set_data);
+}
+
+/*
+ * Send time role get command
+ */
+void mesh_time_role_get(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length)
+{
+    MESH_TIME_TRACE(DEBUG, ROLE_GET, p_event->dst, 0, 0);
+
+    wiced_bt_mesh_model_time_client_time_role_get_send(p_event);
+}
+
+/*
+ * Send time role set command
+ */
+void mesh_time_role_set(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length)
+{
+    wiced_bt_mesh_time_role_msg_t set_data;
+
+    STREAM_TO_UINT8(set_data.role, p_data);
+
+    MESH_TIME_TRACE(INFO, ROLE_SET, p_event->dst, set_data.role, 0);
+
+    wiced_bt_mesh_model_time_client_time_role_set_send(p_event, &set_data);
+}
+
+/*
+ * Send get command received from the host, num_waiters is 0 for the gets sent by the client
+ * itself. If the same get to the same destination is already outstanding, the request is
+ * coalesced with it and no new message is sent. Gets to unicast addresses are retried with
+ * increasing timeout until the status is received.
+ */
+void mesh_time_request_send(wiced_bt_mesh_event_t *p_event, const mesh_time_command_t *p_cmd, uint8_t num_waiters)
+{
+    mesh_time_request_t *p_request;
+    mesh_time_request_t *p_free = NULL;
+    uint16_t opcode = p_cmd->opcode;
+    uint8_t num_used = 0;
+    int i;
+
+    // Gets to a group are answered by many servers and are not tracked
+    if ((p_event->dst & 0x8000) == 0)
+    {
+        for (i = 0; i < MESH_TIME_REQUEST_POOL_SIZE; i++)
+        {
+            p_request = &mesh_time_request.request[i];
+            if ((p_request->opcode == opcode) && (p_request->dst == p_event->dst))
+            {
+                MESH_TIME_TRACE(DEBUG, REQUEST_COALESCED, opcode, p_event->dst, p_request->num_waiters);
+                if (p_request->num_waiters + num_waiters <= 0xFF)
+                    p_request->num_waiters += num_waiters;
+                wiced_bt_mesh_release_event(p_event);
+                return;
+            }
+            if (p_request->opcode != 0)
+                num_used++;
+            else if (p_free == NULL)
+                p_free = p_request;
+        }
+        // If the pool is exhausted the get is sent without tracking
+        if (p_free == NULL)
+        {
+            mesh_time_request.num_untracked++;
+        }
+        else
+        {
+            if (num_used + 1 > mesh_time_request.high_water)
+                mesh_time_request.high_water = num_used + 1;
+
+            memcpy(&p_free->hdr, p_event, sizeof(wiced_bt_mesh_event_t));
+            p_free->opcode      = opcode;
+            p_free->p_cmd       = p_cmd;
+            p_free->dst         = p_event->dst;
+            p_free->num_waiters = num_waiters;
+            p_free->retries     = MESH_TIME_REQUEST_MAX_RETRIES;
+            p_free->timeout     = MESH_TIME_REQUEST_TIMEOUT;
+            p_free->tx_ms       = mesh_time_client_get_tick_ms();
+            p_free->deadline_ms = p_free->tx_ms + MESH_TIME_REQUEST_TIMEOUT;
+            mesh_time_request_timer_restart();
+        }
+    }
+    mesh_time_request_transmit(p_cmd, p_event);
+}
+
+/*
+ * Send get message corresponding to the HCI command
+ */
+void mesh_time_request_transmit(const mesh_time_command_t *p_cmd, wiced_bt_mesh_event_t *p_event)
+{
+    p_cmd->p_mesh_handler(p_event, NULL, 0);
+}
+
+/*
+ * Status has been received, release the request. Returns number of host requests waiting
+ * for the status, 0 if the status is not a reply to a tracked get.
+ */
+uint8_t mesh_time_request_complete(uint16_t opcode, uint16_t src)
+{
+    mesh_time_request_t *p_request;
+    uint8_t num_waiters;
+    int i;
+
+    for (i = 0; i < MESH_TIME_REQUEST_POOL_SIZE; i++)
+    {
+        p_request = &mesh_time_request.request[i];
+        if ((p_request->opcode == opcode) && (p_request->dst == src))
+        {
+            num_waiters = p_request->num_waiters;
+            p_request->opcode = 0;
+            mesh_time_request_timer_restart();
+
+            // Batch gets waiting for the tracker can be sent
+            mesh_time_batch_resume();
+            return num_waiters;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Local time when the get answered by the status has been sent. Returns 0 if the get is not
+ * tracked or has been retried, the reply cannot be matched with one transmission then.
+ */
+uint64_t mesh_time_request_tx_ms(uint16_t opcode, uint16_t src)
+{
+    int i;
+
+    for (i = 0; i < MESH_TIME_REQUEST_POOL_SIZE; i++)
+    {
+        if ((mesh_time_request.request[i].opcode == opcode) && (mesh_time_request.request[i].dst == src))
+            return mesh_time_request.request[i].tx_ms;
+    }
+    return 0;
+}
+
+/*
+ * Number of free entries of the request tracker
+ */
+uint8_t mesh_time_request_num_free(void)
+{
+    uint8_t num_free = 0;
+    int i;
+
+    for (i = 0; i < MESH_TIME_REQUEST_POOL_SIZE; i++)
+    {
+        if (mesh_time_request.request[i].opcode == 0)
+            num_free++;
+    }
+    return num_free;
+}
+
+/*
+ * Start the timer for the earliest deadline of the pending requests
+ */
+void mesh_time_request_timer_restart(void)
+{
+    uint64_t now = mesh_time_client_get_tick_ms();
+    uint64_t deadline = (uint64_t)-1;
+    int i;
+
+    wiced_stop_timer(&mesh_time_request.timer);
+
+    for (i = 0; i < MESH_TIME_REQUEST_POOL_SIZE; i++)
+    {
+        if ((mesh_time_request.request[i].opcode != 0) && (mesh_time_request.request[i].deadline_ms < deadline))
+            deadline = mesh_time_request.request[i].deadline_ms;
+    }
+    if (deadline != (uint64_t)-1)
+        wiced_start_timer(&mesh_time_request.timer, (deadline > now) ? (uint32_t)(deadline - now) : 1);
+}
+
+/*
+ * Retry the gets which have not been answered in time with doubled timeout. When all retries
+ * are used, each waiting host request receives the timeout event.
+ */
+void mesh_time_request_timeout(TIMER_PARAM_TYPE arg)
+{
+    mesh_time_request_t *p_request;
+    wiced_bt_mesh_event_t *p_event;
+    uint64_t now = mesh_time_client_get_tick_ms();
+    int i;
+
+    for (i = 0; i < MESH_TIME_REQUEST_POOL_SIZE; i++)
+    {
+        p_request = &mesh_time_request.request[i];
+        if ((p_request->opcode == 0) || (p_request->deadline_ms > now))
+            continue;
+
+        if (p_request->retries == 0)
+        {
+            MESH_TIME_TRACE(INFO, REQUEST_TIMEOUT, p_request->opcode, p_request->dst, p_request->num_waiters);
+#ifdef HCI_CONTROL
+            mesh_time_request_timeout_hci_event_send(p_request);
+#endif
+            mesh_time_stats_timeout(p_request->opcode, p_request->dst);
+            if (p_request->opcode == HCI_CONTROL_MESH_COMMAND_TIME_GET)
+                mesh_time_batch_request_timeout(p_request->dst);
+            p_request->opcode = 0;
+            continue;
+        }
+        p_request->retries--;
+        p_request->timeout *= 2;
+        p_request->deadline_ms = now + p_request->timeout;
+        p_request->tx_ms = 0;
+
+        MESH_TIME_TRACE(DEBUG, REQUEST_RETRY, p_request->opcode, p_request->dst, p_request->retries);
+        mesh_time_stats_retry(p_request->opcode);
+
+        p_event = mesh_time_event_copy(&p_request->hdr, p_request->dst);
+        if (p_event == NULL)
+            continue;
+
+        mesh_time_request_transmit(p_request->p_cmd, p_event);
+    }
+    mesh_time_request_timer_restart();
+    mesh_time_batch_resume();
+}
+
+/*
+ * Index of the command in the statistics table, MESH_TIME_STATS_NUM_OPCODES if not counted
+ */
+uint8_t mesh_time_stats_opcode_idx(uint16_t opcode)
+{
+    uint8_t i;
+
+    for (i = 0; i < MESH_TIME_STATS_NUM_OPCODES; i++)
+    {
+        if (mesh_time_stats_opcode[i] == opcode)
+            break;
+    }
+    return i;
+}
+
+/*
+ * Index of the status expected as a reply to the command. Commands are ordered by
+ * pairs of get and set, both answered with the same status.
+ */
+uint8_t mesh_time_stats_status_idx(uint8_t opcode_idx)
+{
+    return opcode_idx / 2;
+}
+
+/*
+ * Counters of the destination. If the destination is not in the table, the entry is
+ * replaced in round robin order when create is set.
+ */
+mesh_time_dst_stats_t *mesh_time_stats_dst_find(uint16_t addr, wiced_bool_t create)
+{
+    mesh_time_dst_stats_t *p_dst;
+    int i;
+
+    for (i = 0; i < MESH_TIME_STATS_NUM_DST; i++)
+    {
+        if (mesh_time_stats.dst[i].addr == addr)
+            return &mesh_time_stats.dst[i];
+    }
+    if (!create)
+        return NULL;
+
+    for (i = 0; i < MESH_TIME_STATS_NUM_DST; i++)
+    {
+        if (mesh_time_stats.dst[i].addr == 0)
+            break;
+    }
+    if (i == MESH_TIME_STATS_NUM_DST)
+    {
+        i = mesh_time_stats.next_dst;
+        mesh_time_stats.next_dst = (mesh_time_stats.next_dst + 1) % MESH_TIME_STATS_NUM_DST;
+    }
+    p_dst = &mesh_time_stats.dst[i];
+    memset(p_dst, 0, sizeof(mesh_time_dst_stats_t));
+    p_dst->addr = addr;
+    return p_dst;
+}
+
+/*
+ * Command received from the host is about to be sent. Commands to a unicast address which
+ * expect a reply are timestamped to measure the round trip when the status is received.
+ * A coalesced get keeps the timestamp of the first request.
+ */
+void mesh_time_stats_command(uint16_t opcode, wiced_bt_mesh_event_t *p_event)
+{
+    mesh_time_dst_stats_t *p_dst;
+    uint8_t opcode_idx = mesh_time_stats_opcode_idx(opcode);
+    uint8_t status_idx;
+    wiced_bool_t is_get;
+
+    if (opcode_idx == MESH_TIME_STATS_NUM_OPCODES)
+        return;
+
+    mesh_time_stats.opcode[opcode_idx].num_cmd++;
+
+    is_get = ((opcode_idx & 1) == 0);
+    if ((p_event->dst == 0) || ((p_event->dst & 0x8000) != 0) || (!is_get && !p_event->reply))
+        return;
+
+    p_dst = mesh_time_stats_dst_find(p_event->dst, WICED_TRUE);
+    p_dst->num_cmd++;
+
+    status_idx = mesh_time_stats_status_idx(opcode_idx);
+    if (p_dst->pending & (1 << status_idx))
+    {
+        if (is_get && (p_dst->opcode_idx[status_idx] == opcode_idx))
+            return;
+
+        // Previous command is superseded before the reply
+        mesh_time_stats.opcode[p_dst->opcode_idx[status_idx]].num_lost++;
+        p_dst->num_lost++;
+    }
+    p_dst->pending |= (1 << status_idx);
+    p_dst->opcode_idx[status_idx] = opcode_idx;
+    p_dst->tx_ms[status_idx] = (uint32_t)mesh_time_client_get_tick_ms();
+}
+
+/*
+ * Status received from the server. If a command is waiting for it, the round trip time
+ * is added to the histogram of the command and to the destination counters.
+ */
+void mesh_time_stats_status(uint16_t event, uint16_t src)
+{
+    mesh_time_opcode_stats_t *p_opcode;
+    mesh_time_dst_stats_t *p_dst;
+    uint8_t  status_idx;
+    uint8_t  bucket;
+    uint32_t rtt;
+
+    switch (event)
+    {
+    case WICED_BT_MESH_TIME_STATUS:
+        status_idx = 0;
+        break;
+    case WICED_BT_MESH_TIME_ZONE_STATUS:
+        status_idx = 1;
+        break;
+    case WICED_BT_MESH_TAI_UTC_DELTA_STATUS:
+        status_idx = 2;
+        break;
+    case WICED_BT_MESH_TIME_ROLE_STATUS:
+        status_idx = 3;
+        break;
+    default:
+        return;
+    }
+    p_dst = mesh_time_stats_dst_find(src, WICED_FALSE);
+    if ((p_dst == NULL) || ((p_dst->pending & (1 << status_idx)) == 0))
+    {
+        mesh_time_stats.num_unsolicited++;
+        return;
+    }
+    p_dst->pending &= ~(1 << status_idx);
+
+    rtt = (uint32_t)mesh_time_client_get_tick_ms() - p_dst->tx_ms[status_idx];
+
+    for (bucket = 0; (bucket < MESH_TIME_STATS_NUM_BUCKETS - 1) && ((rtt >> (bucket + 1)) != 0); bucket++)
+        ;
+
+    p_opcode = &mesh_time_stats.opcode[p_dst->opcode_idx[status_idx]];
+    p_opcode->num_reply++;
+    if (p_opcode->rtt_hist[bucket] != 0xFFFF)
+        p_opcode->rtt_hist[bucket]++;
+
+    if (rtt > 0xFFFF)
+        rtt = 0xFFFF;
+    p_dst->num_reply++;
+    if (rtt > p_dst->max_rtt_ms)
+        p_dst->max_rtt_ms = (uint16_t)rtt;
+    if (p_dst->srtt_ms == 0)
+        p_dst->srtt_ms = (uint16_t)rtt;
+    else
+        p_dst->srtt_ms = (uint16_t)(((uint32_t)p_dst->srtt_ms * 7 + rtt) / 8);
+}
+
+/*
+ * Get is retransmitted because the status has not been received in time
+ */
+void mesh_time_stats_retry(uint16_t opcode)
+{
+    uint8_t opcode_idx = mesh_time_stats_opcode_idx(opcode);
+
+    if (opcode_idx < MESH_TIME_STATS_NUM_OPCODES)
+        mesh_time_stats.opcode[opcode_idx].num_retry++;
+}
+
+/*
+ * Get has not been answered after all retries
+ */
+void mesh_time_stats_timeout(uint16_t opcode, uint16_t dst)
+{
+    mesh_time_dst_stats_t *p_dst;
+    uint8_t opcode_idx = mesh_time_stats_opcode_idx(opcode);
+    uint8_t status_idx;
+
+    if (opcode_idx == MESH_TIME_STATS_NUM_OPCODES)
+        return;
+
+    mesh_time_stats.opcode[opcode_idx].num_lost++;
+
+    status_idx = mesh_time_stats_status_idx(opcode_idx);
+    p_dst = mesh_time_stats_dst_find(dst, WICED_FALSE);
+    if ((p_dst != NULL) && (p_dst->pending & (1 << status_idx)))
+    {
+        p_dst->pending &= ~(1 << status_idx);
+        p_dst->num_lost++;
+    }
+}
+
+/*
+ * Clear all counters. Commands waiting for the reply stay pending.
+ */
+void mesh_time_stats_reset(void)
+{
+    int i;
+
+    mesh_time_stats.num_unknown_event = 0;
+    mesh_time_stats.num_unknown_cmd   = 0;
+    mesh_time_stats.num_bad_hdr       = 0;
+    mesh_time_stats.num_unsolicited   = 0;
+    memset(mesh_time_stats.opcode, 0, sizeof(mesh_time_stats.opcode));
+
+    for (i = 0; i < MESH_TIME_STATS_NUM_DST; i++)
+    {
+        mesh_time_stats.dst[i].num_cmd    = 0;
+        mesh_time_stats.dst[i].num_reply  = 0;
+        mesh_time_stats.dst[i].num_lost   = 0;
+        mesh_time_stats.dst[i].srtt_ms    = 0;
+        mesh_time_stats.dst[i].max_rtt_ms = 0;
+    }
+}
+
+/*
+ * Send time get command to each Time Server in the list. Header of the command provides
+ * the addressing parameters, the destination in the header is not used. The data contains
+ * the deadline in seconds (0 for default), number of servers and the list of addresses.
+ * Gets are sent at the rate of the set messages pacing and only while the request tracker has
+ * more than MESH_TIME_BATCH_RESERVED_REQUESTS free entries, so that each get is tracked and
+ * retried as the host gets. The deadline counts from the last get, the default one covers all
+ * its retries. Replies are collected and reported in HCI_CONTROL_MESH_EVENT_TIME_GET_BATCH_STATUS
+ * events when all servers replied or did not reply to all retries, or when the deadline expires.
+ */
+void mesh_time_get_batch(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length)
+{
+    uint8_t  timeout;
+    uint8_t  num_dst;
+    uint16_t i;
+
+    STREAM_TO_UINT8(timeout, p_data);
+    STREAM_TO_UINT8(num_dst, p_data);
+    if ((num_dst == 0) || (num_dst > MESH_TIME_BATCH_MAX_DST) || (length < MESH_TIME_GET_BATCH_PARAM_LEN + 2 * (uint32_t)num_dst))
+    {
+        MESH_TIME_TRACE(ERROR, BAD_LEN, HCI_CONTROL_MESH_COMMAND_TIME_GET_BATCH, length, 0);
+        wiced_bt_mesh_release_event(p_event);
+        return;
+    }
+
+    MESH_TIME_TRACE(INFO, BATCH_GET, num_dst, timeout, 0);
+
+    // Previous batch is reported with the results received so far
+    if (mesh_time_batch.in_progress)
+        mesh_time_batch_complete();
+
+    memcpy(&mesh_time_batch.hdr, p_event, sizeof(wiced_bt_mesh_event_t));
+    wiced_bt_mesh_release_event(p_event);
+
+    mesh_time_batch.num_dst     = num_dst;
+    mesh_time_batch.num_replied = 0;
+    mesh_time_batch.num_done    = 0;
+    mesh_time_batch.num_sent    = 0;
+    mesh_time_batch.timeout     = (timeout != 0) ? timeout : MESH_TIME_BATCH_DEFAULT_TIMEOUT;
+    for (i = 0; i < num_dst; i++)
+    {
+        STREAM_TO_UINT16(mesh_time_batch.entry[i].dst, p_data);
+        mesh_time_batch.entry[i].replied = WICED_FALSE;
+        mesh_time_batch.entry[i].done    = WICED_FALSE;
+    }
+    mesh_time_batch.in_progress = WICED_TRUE;
+
+    mesh_time_batch_resume();
+}
+
+/*
+ * Returns WICED_TRUE if a get of the batch is waiting and the request tracker can take it
+ */
+wiced_bool_t mesh_time_batch_ready(void)
+{
+    return mesh_time_batch.in_progress && (mesh_time_batch.num_sent < mesh_time_batch.num_dst) &&
+           (mesh_time_request_num_free() > MESH_TIME_BATCH_RESERVED_REQUESTS);
+}
+
+/*
+ * Send Time Get to the next server of the batch. The deadline is started after the last get.
+ * Returns WICED_FALSE if there is no get waiting to be sent or the request tracker is full.
+ */
+wiced_bool_t mesh_time_batch_send_next(void)
+{
+    if (!mesh_time_batch_ready())
+        return WICED_FALSE;
+
+    mesh_time_client_time_get_send(&mesh_time_batch.hdr, mesh_time_batch.entry[mesh_time_batch.num_sent].dst);
+    if (++mesh_time_batch.num_sent == mesh_time_batch.num_dst)
+        wiced_start_timer(&mesh_time_batch.timer, mesh_time_batch.timeout);
+    return WICED_TRUE;
+}
+
+/*
+ * Send the gets of the batch which can be sent now, directly if the pacing is disabled
+ */
+void mesh_time_batch_resume(void)
+{
+    if (!mesh_time_batch_ready())
+        return;
+
+    if (mesh_time_pace.rate == 0)
+    {
+        while (mesh_time_batch_send_next())
+            ;
+    }
+    else
+    {
+        mesh_time_pace_run(WICED_FALSE);
+    }
+}
+
+/*
+ * Create event to send a message to the destination using addressing parameters of the header
+ */
+wiced_bt_mesh_event_t *mesh_time_event_copy(wiced_bt_mesh_event_t *p_hdr, uint16_t dst)
+{
+    wiced_bt_mesh_event_t *p_event;
+
+    p_event = wiced_bt_mesh_create_event(p_hdr->element_idx, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_TIME_CLNT, dst, p_hdr->app_key_idx);
+    if (p_event == NULL)
+        return NULL;
+
+    p_event->ttl           = p_hdr->ttl;
+    p_event->retrans_cnt   = p_hdr->retrans_cnt;
+    p_event->retrans_time  = p_hdr->retrans_time;
+    p_event->reply         = p_hdr->reply;
+    p_event->reply_timeout = p_hdr->reply_timeout;
+    return p_event;
+}
+
+#if !LOW_POWER_NODE
+/*
+ * Configure time updates to the Low Power Nodes attached to this friend. The data contains the
+ * element index, application key index (2 bytes), number of polls between updates (2 bytes, 0 to
+ * stop the updates), number of nodes, and for each node the address (2 bytes), the poll interval
+ * in 100 ms units (2 bytes) and the time in milliseconds until the next poll (2 bytes, 0 if
+ * unknown). Instead of relaying statuses which wait in the friend cache for a poll, the friend
+ * sends Time Set with its own disciplined time just before the poll, corrected for the time
+ * the message stays in the cache.
+ * The mesh core library handles the Friend Poll internally and does not report it to the
+ * application, so the polls are predicted from the poll interval and the phase provided by the
+ * host. The host sees the friendships and the poll timing in the core events and sends the
+ * command again when they change.
+ */
+void mesh_time_proxy_set(uint8_t *p_data, uint32_t length)
+{
+    mesh_time_proxy_lpn_t *p_lpn;
+    uint64_t now = mesh_time_client_get_tick_ms();
+    uint16_t poll_interval;
+    uint16_t next_poll;
+    uint8_t  num_lpn;
+    uint8_t  i;
+
+    STREAM_TO_UINT8(mesh_time_proxy.element_idx, p_data);
+    STREAM_TO_UINT16(mesh_time_proxy.app_key_idx, p_data);
+    STREAM_TO_UINT16(mesh_time_proxy.update_polls, p_data);
+    STREAM_TO_UINT8(num_lpn, p_data);
+    length -= MESH_TIME_PROXY_SET_PARAM_LEN;
+
+    if ((num_lpn > MESH_TIME_PROXY_MAX_LPN) || (length < (uint32_t)num_lpn * 6))
+    {
+        MESH_TIME_TRACE(ERROR, BAD_LEN, HCI_CONTROL_MESH_COMMAND_TIME_PROXY_SET, length, num_lpn);
+        return;
+    }
+    mesh_time_proxy.num_lpn = 0;
+    for (i = 0; i < num_lpn; i++)
+    {
+        p_lpn = &mesh_time_proxy.lpn[mesh_time_proxy.num_lpn];
+        STREAM_TO_UINT16(p_lpn->addr, p_data);
+        STREAM_TO_UINT16(poll_interval, p_data);
+        STREAM_TO_UINT16(next_poll, p_data);
+
+        if ((p_lpn->addr == 0) || (p_lpn->addr & 0x8000) || (poll_interval == 0))
+            continue;
+
+        p_lpn->poll_interval_ms = (uint32_t)poll_interval * 100;
+        p_lpn->next_poll_ms     = now + ((next_poll != 0) ? next_poll : p_lpn->poll_interval_ms);
+        p_lpn->polls_to_update  = 1;
+        p_lpn->num_updates      = 0;
+        mesh_time_proxy.num_lpn++;
+    }
+    MESH_TIME_TRACE(INFO, PROXY_CONFIG, mesh_time_proxy.num_lpn, mesh_time_proxy.update_polls, 0);
+
+    mesh_time_proxy_timer_restart();
+#ifdef HCI_CONTROL
+    mesh_time_proxy_status_hci_event_send();
+#endif
+}
+
+/*
+ * Start the timer to send the update before the earliest predicted poll
+ */
+void mesh_time_proxy_timer_restart(void)
+{
+    uint64_t now = mesh_time_client_get_tick_ms();
+    uint64_t next = (uint64_t)-1;
+    uint8_t  i;
+
+    wiced_stop_timer(&mesh_time_proxy.timer);
+    if (mesh_time_proxy.update_polls == 0)
+        return;
+
+    for (i = 0; i < mesh_time_proxy.num_lpn; i++)
+    {
+        if (mesh_time_proxy.lpn[i].next_poll_ms < next)
+            next = mesh_time_proxy.lpn[i].next_poll_ms;
+    }
+    if (next == (uint64_t)-1)
+        return;
+
+    next -= MESH_TIME_PROXY_SEND_ADVANCE;
+    wiced_start_timer(&mesh_time_proxy.timer, (next > now) ? (uint32_t)(next - now) : 1);
+}
+
+/*
+ * A poll of one or more Low Power Nodes is expected soon. Send the time update if it is due
+ * and predict the next poll.
+ */
+void mesh_time_proxy_timeout(TIMER_PARAM_TYPE arg)
+{
+    mesh_time_proxy_lpn_t *p_lpn;
+    uint64_t now = mesh_time_client_get_tick_ms();
+    uint8_t  i;
+
+    for (i = 0; i < mesh_time_proxy.num_lpn; i++)
+    {
+        p_lpn = &mesh_time_proxy.lpn[i];
+        if (p_lpn->next_poll_ms > now + MESH_TIME_PROXY_SEND_ADVANCE)
+            continue;
+
+        if (--p_lpn->polls_to_update == 0)
+        {
+            p_lpn->polls_to_update = mesh_time_proxy.update_polls;
+            mesh_time_proxy_update_send(p_lpn, (p_lpn->next_poll_ms > now) ? (uint32_t)(p_lpn->next_poll_ms - now) : 0);
+        }
+        // Skip the polls missed while the timer was delayed
+        do
+        {
+            p_lpn->next_poll_ms += p_lpn->poll_interval_ms;
+        } while (p_lpn->next_poll_ms <= now + MESH_TIME_PROXY_SEND_ADVANCE);
+    }
+    mesh_time_proxy_timer_restart();
+}
+
+/*
+ * Send Time Set with the local time at which the Low Power Node is expected to receive it.
+ * The message waits in the friend cache until the poll and is delivered within the receive
+ * window, the half of the window is added to the residency and to the uncertainty.
+ */
+void mesh_time_proxy_update_send(mesh_time_proxy_lpn_t *p_lpn, uint32_t residency_ms)
+{
+    wiced_bt_mesh_time_state_msg_t set_data;
+    wiced_bt_mesh_event_t *p_event;
+    uint64_t time_ms;
+    uint32_t uncertainty_ms;
+
+    if (!mesh_time_client_get_time(&set_data))
+    {
+        mesh_time_proxy.num_skipped++;
+        return;
+    }
+    residency_ms  += mesh_config.friend_cfg.receive_window / 2;
+    uncertainty_ms = (uint32_t)set_data.uncertainty * 10 + mesh_config.friend_cfg.receive_window / 2;
+
+    // The friend forwards the time of its source, it is not the Time Authority itself
+    set_data.time_authority = 0;
+
+    time_ms = set_data.tai_seconds * 1000 + ((uint32_t)set_data.subsecond * 1000) / 256 + residency_ms;
+    set_data.tai_seconds = time_ms / 1000;
+    set_data.subsecond   = (uint8_t)(((time_ms % 1000) * 256) / 1000);
+    set_data.uncertainty = (uint8_t)(uncertainty_ms >= 2550 ? 0xFF : uncertainty_ms / 10);
+
+    p_event = wiced_bt_mesh_create_event(mesh_time_proxy.element_idx, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_TIME_CLNT,
+                                         p_lpn->addr, mesh_time_proxy.app_key_idx);
+    if (p_event == NULL)
+    {
+        MESH_TIME_TRACE(ERROR, NO_MEM, HCI_CONTROL_MESH_COMMAND_TIME_SET, p_lpn->addr, 0);
+        return;
+    }
+    // Update is not acknowledged to keep the friend cache for the time updates
+    p_event->reply = 0;
+
+    MESH_TIME_TRACE(DEBUG, PROXY_UPDATE, p_lpn->addr, set_data.tai_seconds, residency_ms);
+
+    p_lpn->num_updates++;
+    wiced_bt_mesh_model_time_client_time_set_send(p_event, &set_data);
+}
+#endif
+
+/*
+ * Send Time Get to the destination using addressing parameters of the header. The get is
+ * tracked and retried, but the timeout is not reported to the host.
+ */
+void mesh_time_client_time_get_send(wiced_bt_mesh_event_t *p_hdr, uint16_t dst)
+{
+    wiced_bt_mesh_event_t *p_get;
+
+#if LOW_POWER_NODE
+    if (mesh_time_lpn_defer(HCI_CONTROL_MESH_COMMAND_TIME_GET, p_hdr, dst, WICED_FALSE))
+        return;
+#endif
+    p_get = mesh_time_event_copy(p_hdr, dst);
+    if (p_get == NULL)
+    {
+        MESH_TIME_TRACE(ERROR, NO_MEM, HCI_CONTROL_MESH_COMMAND_TIME_GET, dst, 0);
+        return;
+    }
+    // Tracked as the host gets, the request keeps the send time for the round trip measurement
+    mesh_time_request_send(p_get, mesh_time_command_find(HCI_CONTROL_MESH_COMMAND_TIME_GET), 0);
+}
+
+#if LOW_POWER_NODE
+/*
+ * Low Power Node should not wake up the radio for each get. If deferral is enabled, the get is
+ * queued and sent just before the next poll of the friend, when the node is awake anyway.
+ * Returns WICED_FALSE if the get should be sent now.
+ */
+wiced_bool_t mesh_time_lpn_defer(uint16_t opcode, wiced_bt_mesh_event_t *p_hdr, uint16_t dst, wiced_bool_t host)
+{
+    mesh_time_lpn_entry_t *p_entry = NULL;
+    int i;
+
+    if (mesh_time_lpn.flushing)
+        return WICED_FALSE;
+
+    if (!mesh_time_lpn.enabled)
+    {
+        mesh_time_lpn.num_tx_wakeups++;
+        return WICED_FALSE;
+    }
+    for (i = 0; i < MESH_TIME_LPN_QUEUE_SIZE; i++)
+    {
+        if (mesh_time_lpn.entry[i].opcode == 0)
+        {
+            p_entry = &mesh_time_lpn.entry[i];
+            break;
+        }
+    }
+    // If the queue is full, deferred gets are sent together with the new one
+    if (p_entry == NULL)
+    {
+        mesh_time_lpn_flush(0);
+        return WICED_FALSE;
+    }
+    memcpy(&p_entry->hdr, p_hdr, sizeof(wiced_bt_mesh_event_t));
+    p_entry->hdr.dst = dst;
+    p_entry->opcode  = opcode;
+    p_entry->host    = host;
+    mesh_time_lpn.num_deferred++;
+
+    MESH_TIME_TRACE(DEBUG, LPN_DEFER, opcode, dst, mesh_time_lpn.depth);
+
+    // The first deferred get is sent after the max deferral time if the friend is not polled before
+    if (mesh_time_lpn.depth++ == 0)
+        wiced_start_timer(&mesh_time_lpn.timer, MESH_TIME_LPN_MAX_DEFER);
+    return WICED_TRUE;
+}
+
+/*
+ * Send all deferred gets in one radio activity. Host gets are tracked for the reply and retried.
+ */
+void mesh_time_lpn_flush(TIMER_PARAM_TYPE arg)
+{
+    mesh_time_lpn_entry_t *p_entry;
+    wiced_bt_mesh_event_t *p_event;
+    int i;
+
+    wiced_stop_timer(&mesh_time_lpn.timer);
+    if (mesh_time_lpn.depth == 0)
+        return;
+
+    MESH_TIME_TRACE(DEBUG, LPN_FLUSH, mesh_time_lpn.depth, 0, 0);
+
+    mesh_time_lpn.flushing = WICED_TRUE;
+    mesh_time_lpn.num_tx_wakeups++;
+
+    for (i = 0; i < MESH_TIME_LPN_QUEUE_SIZE; i++)
+    {
+        p_entry = &mesh_time_lpn.entry[i];
+        if (p_entry->opcode == 0)
+            continue;
+
+        if (p_entry->host)
+        {
+            if ((p_event = mesh_time_event_copy(&p_entry->hdr, p_entry->hdr.dst)) != NULL)
+                mesh_time_request_send(p_event, mesh_time_command_find(p_entry->opcode), 1);
+        }
+        else
+        {
+            mesh_time_client_time_get_send(&p_entry->hdr, p_entry->hdr.dst);
+        }
+        p_entry->opcode = 0;
+    }
+    mesh_time_lpn.depth    = 0;
+    mesh_time_lpn.flushing = WICED_FALSE;
+}
+
+/*
+ * Mesh core is going to sleep until the next poll of the friend. Deferred gets do not survive
+ * HID-Off, they are sent now and the device stays awake, the core calls again when it is idle.
+ * Otherwise the device enters HID-Off as with the default sleep of the mesh application. Time
+ * between the expected wake up and the next sleep is accounted as on-time.
+ */
+void mesh_time_lpn_sleep(uint32_t max_sleep_duration)
+{
+    uint64_t now = mesh_time_client_get_tick_ms();
+    wiced_result_t result;
+
+    if ((mesh_time_lpn.awake_ms != 0) && (now > mesh_time_lpn.awake_ms))
+        mesh_time_lpn.on_time_ms += (uint32_t)(now - mesh_time_lpn.awake_ms);
+    mesh_time_lpn.awake_ms = now + max_sleep_duration;
+    mesh_time_lpn.num_sleep++;
+
+    if (mesh_time_lpn.depth != 0)
+    {
+        mesh_time_lpn_flush(0);
+        return;
+    }
+    if ((result = wiced_sleep_enter_hid_off(max_sleep_duration, 0, 0)) != WICED_SUCCESS)
+        MESH_TIME_TRACE(ERROR, LPN_SLEEP_FAIL, max_sleep_duration, result, 0);
+}
+
+/*
+ * Enable or disable deferral of the gets to the friend poll. Gets waiting in the queue
+ * are sent immediately when deferral is disabled.
+ */
+void mesh_time_lpn_set(uint8_t *p_data, uint32_t length)
+{
+    mesh_time_lpn.enabled = (p_data[0] != 0) ? WICED_TRUE : WICED_FALSE;
+    if (!mesh_time_lpn.enabled)
+        mesh_time_lpn_flush(0);
+
+#ifdef HCI_CONTROL
+    mesh_time_lpn_status_hci_event_send();
+#endif
+}
+#endif
+
+/*
+ * Save Time Status if it is a reply to the batch get. Returns WICED_TRUE if the status
+ * has been consumed by the batch and should not be reported separately.
+ */
+wiced_bool_t mesh_time_batch_status_process(uint16_t src, wiced_bt_mesh_time_state_msg_t *p_time_status)
+{
+    uint16_t i;
+
+    if (!mesh_time_batch.in_progress)
+        return WICED_FALSE;
+
+    for (i = 0; i < mesh_time_batch.num_dst; i++)
+    {
+        if (mesh_time_batch.entry[i].dst == src)
+            break;
+    }
+    if (i == mesh_time_batch.num_dst)
+        return WICED_FALSE;
+
+    if (!mesh_time_batch.entry[i].replied)
+    {
+        mesh_time_state_to_stream(mesh_time_batch.entry[i].state, p_time_status);
+        mesh_time_batch.entry[i].replied = WICED_TRUE;
+        mesh_time_batch.num_replied++;
+        if (!mesh_time_batch.entry[i].done)
+        {
+            mesh_time_batch.entry[i].done = WICED_TRUE;
+            if (++mesh_time_batch.num_done == mesh_time_batch.num_dst)
+                mesh_time_batch_complete();
+        }
+    }
+    return WICED_TRUE;
+}
+
+/*
+ * All retries of the Time Get to the server have been used. The batch is reported without
+ * waiting for the deadline if no other server is expected to reply.
+ */
+void mesh_time_batch_request_timeout(uint16_t dst)
+{
+    uint16_t i;
+
+    if (!mesh_time_batch.in_progress)
+        return;
+
+    for (i = 0; i < mesh_time_batch.num_dst; i++)
+    {
+        if ((mesh_time_batch.entry[i].dst == dst) && !mesh_time_batch.entry[i].done)
+        {
+            mesh_time_batch.entry[i].done = WICED_TRUE;
+            if (++mesh_time_batch.num_done == mesh_time_batch.num_dst)
+                mesh_time_batch_complete();
+            return;
+        }
+    }
+}
+
+/*
+ * Report results of the batch get to the host
+ */
+void mesh_time_batch_complete(void)
+{
+#ifdef HCI_CONTROL
+    uint16_t first;
+    uint16_t count;
+#endif
+
+    MESH_TIME_TRACE(INFO, BATCH_COMPLETE, mesh_time_batch.num_replied, mesh_time_batch.num_dst, 0);
+
+    wiced_stop_timer(&mesh_time_batch.timer);
+    mesh_time_batch.in_progress = WICED_FALSE;
+
+#ifdef HCI_CONTROL
+    for (first = 0; first < mesh_time_batch.num_dst; first += count)
+    {
+        count = mesh_time_batch.num_dst - first;
+        if (count > MESH_TIME_BATCH_ENTRIES_PER_EVENT)
+            count = MESH_TIME_BATCH_ENTRIES_PER_EVENT;
+        mesh_time_batch_status_hci_event_send(first, count);
+    }
+#endif
+}
+
+/*
+ * Batch deadline expired, report servers which did not reply
+ */
+void mesh_time_batch_timeout(TIMER_PARAM_TYPE arg)
+{
+    if (mesh_time_batch.in_progress)
+        mesh_time_batch_complete();
+}
+
+/*
+ * Reply to the time get from the cache if the Time Status of the server is not older than
+ * the max age in seconds provided by the host. The cached time is moved forward by the time
+ * elapsed since the reception. If the cached time is stale, time get is sent to the server.
+ */
+void mesh_time_get_cached(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length)
+{
+    mesh_time_server_t *p_server;
+    wiced_bt_mesh_time_state_msg_t time_status;
+#ifdef HCI_CONTROL
+    wiced_bt_mesh_hci_event_t *p_hci_event;
+#endif
+    uint64_t age_ms;
+    uint32_t subsecond;
+    uint32_t uncertainty;
+    uint16_t max_age = 0;
+
+    if (length >= 2)
+        STREAM_TO_UINT16(max_age, p_data);
+
+    p_server = mesh_time_server_find(p_event->dst, MESH_TIME_SERVER_FIND);
+    if ((p_server == NULL) || !(p_server->flags & MESH_TIME_SERVER_FLAG_TIME_VALID) ||
+        ((age_ms = mesh_time_client_get_tick_ms() - p_server->time_rx_ms) > (uint64_t)max_age * 1000))
+    {
+        MESH_TIME_TRACE(DEBUG, CACHE_MISS, p_event->dst, 0, 0);
+        mesh_time_command_execute(mesh_time_command_find(HCI_CONTROL_MESH_COMMAND_TIME_GET), p_event, NULL, 0);
+        return;
+    }
+
+    // subsecond is in 1/256 second units, uncertainty in 10 ms units
+    time_status = p_server->time;
+    subsecond = time_status.subsecond + (uint32_t)((age_ms * 256) / 1000);
+    time_status.tai_seconds += subsecond >> 8;
+    time_status.subsecond = (uint8_t)subsecond;
+    uncertainty = time_status.uncertainty + (uint32_t)((age_ms * MESH_TIME_CACHE_DRIFT_PPM) / 10000000);
+    time_status.uncertainty = (uint8_t)(uncertainty > 0xFF ? 0xFF : uncertainty);
+
+    MESH_TIME_TRACE(DEBUG, CACHE_HIT, p_event->dst, age_ms, 0);
+
+#ifdef HCI_CONTROL
+    // Report as if the status has been received from the server
+    p_event->src = p_event->dst;
+    if ((p_hci_event = mesh_time_hci_event_create(p_event)) != NULL)
+        mesh_time_status_hci_event_send(p_hci_event, &time_status);
+#endif
+    wiced_bt_mesh_release_event(p_event);
+}
+
+/*
+ * Find the state of the Time Server. If the server is not known, create is MESH_TIME_SERVER_CREATE
+ * or MESH_TIME_SERVER_CREATE_SAMPLED, an unused entry or the entry without samples with the oldest
+ * Time Status is assigned to the server. Entries with samples are only replaced by a server which
+ * receives a sample. The selected source is never replaced. Returns NULL if no entry can be used.
+ */
+mesh_time_server_t *mesh_time_server_find(uint16_t addr, uint8_t create)
+{
+    mesh_time_server_t *p_server;
+    mesh_time_server_t *p_victim = NULL;
+    int i;
+
+    for (i = 0; i < MESH_TIME_CLIENT_MAX_SERVERS; i++)
+    {
+        p_server = &mesh_time_server[i];
+        if (p_server->addr == addr)
+            return p_server;
+
+        if ((p_victim != NULL) && (p_victim->addr == 0))
+            continue;
+        if (p_server->addr == 0)
+        {
+            p_victim = p_server;
+            continue;
+        }
+        if ((p_server->addr == mesh_time_clock.source) ||
+            ((p_server->num_samples != 0) && (create != MESH_TIME_SERVER_CREATE_SAMPLED)))
+            continue;
+
+        // Entries without samples go first, the oldest one in each class
+        if ((p_victim == NULL) ||
+            ((p_server->num_samples == 0) && (p_victim->num_samples != 0)) ||
+            (((p_server->num_samples == 0) == (p_victim->num_samples == 0)) && (p_server->time_rx_ms < p_victim->time_rx_ms)))
+            p_victim = p_server;
+    }
+    if ((create == MESH_TIME_SERVER_FIND) || (p_victim == NULL))
+        return NULL;
+
+    memset(p_victim, 0, sizeof(mesh_time_server_t));
+    p_victim->addr = addr;
+    return p_victim;
+}
+
+/*
+ * Check if the host has configured the server for periodic time sync or if it has been elected
+ * as the Time Authority. Time Status which is not a reply updates the clock only if it comes from
+ * such server. The Low Power Nodes receiving time updates from this friend are never tracked,
+ * their Time Status may echo the time sent by the friend.
+ */
+wiced_bool_t mesh_time_server_is_tracked(uint16_t addr)
+{
+    uint8_t i;
+
+#if !LOW_POWER_NODE
+    for (i = 0; i < mesh_time_proxy.num_lpn; i++)
+    {
+        if (mesh_time_proxy.lpn[i].addr == addr)
+            return WICED_FALSE;
+    }
+#endif
+    if (mesh_time_election.authority == addr)
+        return WICED_TRUE;
+
+    for (i = 0; i < mesh_time_sync.config.num_servers; i++)
+    {
+        if (mesh_time_sync.config.server[i] == addr)
+            return WICED_TRUE;
+    }
+    return WICED_FALSE;
+}
+
+/*
+ * Save received status in the state of the Time Server
+ */
+void mesh_time_server_status_process(uint16_t event, uint16_t src, void *p_data)
+{
+    mesh_time_server_t *p_server;
+    wiced_bt_mesh_time_zone_status_t *p_zone;
+    wiced_bt_mesh_time_tai_utc_delta_status_t *p_delta;
+    uint64_t rx_ms = mesh_time_client_get_tick_ms();
+    uint64_t tx_ms;
+
+    switch (event)
+    {
+    case WICED_BT_MESH_TIME_STATUS:
+        // Only the reply to the get tracked from its first transmission gives the round trip
+        tx_ms = mesh_time_request_tx_ms(HCI_CONTROL_MESH_COMMAND_TIME_GET, src);
+        p_server = mesh_time_server_find(src, (tx_ms != 0) ? MESH_TIME_SERVER_CREATE_SAMPLED : MESH_TIME_SERVER_CREATE);
+        if (p_server == NULL)
+            break;
+        p_server->time = *(wiced_bt_mesh_time_state_msg_t *)p_data;
+        p_server->time_rx_ms = rx_ms;
+        p_server->flags |= MESH_TIME_SERVER_FLAG_TIME_VALID;
+        if (tx_ms != 0)
+        {
+            mesh_time_server_sample_add(p_server, tx_ms, rx_ms);
+            mesh_time_clock_update(p_server, rx_ms);
+            mesh_time_sync_status_process(p_server, rx_ms);
+        }
+        else if (mesh_time_server_is_tracked(src))
+        {
+            mesh_time_clock_status_update(p_server, rx_ms);
+        }
+        break;
+
+    case WICED_BT_MESH_TIME_ZONE_STATUS:
+        p_zone = (wiced_bt_mesh_time_zone_status_t *)p_data;
+        if ((p_server = mesh_time_server_find(src, MESH_TIME_SERVER_CREATE)) != NULL)
+        {
+            p_server->zone = *p_zone;
+            p_server->flags |= MESH_TIME_SERVER_FLAG_ZONE_VALID;
+        }
+        mesh_time_conversion.zone_offset = p_zone->time_zone_offset_current;
+        if (p_zone->tai_of_zone_change != 0)
+            mesh_time_transition_add(mesh_time_conversion.zone_change, &mesh_time_conversion.num_zone_changes,
+                                     p_zone->tai_of_zone_change, p_zone->time_zone_offset_new);
+        break;
+
+    case WICED_BT_MESH_TAI_UTC_DELTA_STATUS:
+        p_delta = (wiced_bt_mesh_time_tai_utc_delta_status_t *)p_data;
+        if ((p_server = mesh_time_server_find(src, MESH_TIME_SERVER_CREATE)) != NULL)
+        {
+            p_server->delta = *p_delta;
+            p_server->flags |= MESH_TIME_SERVER_FLAG_DELTA_VALID;
+        }
+        mesh_time_conversion.tai_utc_delta = p_delta->tai_utc_delta_current;
+        if (p_delta->tai_of_delta_change != 0)
+            mesh_time_transition_add(mesh_time_conversion.delta_change, &mesh_time_conversion.num_delta_changes,
+                                     p_delta->tai_of_delta_change, p_delta->tai_utc_delta_new);
+        break;
+    }
+}
+
+/*
+ * Add the round trip sample of the Time Get sent at tx_ms and run NTP style
+ * clock filter. The sample with the lowest delay in the window is the most accurate one,
+ * its offset is selected, jitter is the mean deviation of the other samples from it.
+ */
+void mesh_time_server_sample_add(mesh_time_server_t *p_server, uint64_t tx_ms, uint64_t rx_ms)
+{
+    mesh_time_sample_t *p_sample = &p_server->sample[p_server->sample_idx];
+    mesh_time_sample_t *p_best;
+    uint64_t server_ms;
+    uint32_t deviation = 0;
+    int64_t  diff;
+    int i;
+
+    // subsecond is in 1/256 second units
+    server_ms = p_server->time.tai_seconds * 1000 + ((uint32_t)p_server->time.subsecond * 1000) / 256;
+
+    p_sample->delay_ms  = (uint32_t)(rx_ms - tx_ms);
+    p_sample->offset_ms = (int64_t)(server_ms + p_sample->delay_ms / 2) - (int64_t)rx_ms;
+
+    p_server->sample_idx = (p_server->sample_idx + 1) % MESH_TIME_FILTER_SIZE;
+    if (p_server->num_samples < MESH_TIME_FILTER_SIZE)
+        p_server->num_samples++;
+
+    p_best = &p_server->sample[0];
+    for (i = 1; i < p_server->num_samples; i++)
+    {
+        if (p_server->sample[i].delay_ms < p_best->delay_ms)
+            p_best = &p_server->sample[i];
+    }
+    for (i = 0; i < p_server->num_samples; i++)
+    {
+        diff = p_server->sample[i].offset_ms - p_best->offset_ms;
+        deviation += (uint32_t)(diff < 0 ? -diff : diff);
+    }
+    p_server->offset_ms = p_best->offset_ms;
+    p_server->delay_ms  = p_best->delay_ms;
+    p_server->jitter_ms = deviation / p_server->num_samples;
+
+    MESH_TIME_TRACE(DEBUG, SAMPLE, p_server->addr, p_sample->delay_ms, (int32_t)(p_sample->offset_ms - p_server->offset_ms));
+}
+
+/*
+ * Start election of the Time Authority and Time Relays among the candidate Time Servers, similar
+ * to the best master clock algorithm of PTP. Header of the command provides the addressing
+ * parameters, the destination in the header is not used. The data contains the number of Time
+ * Relays, the max score of the authority in milliseconds (2 bytes, 0 to ignore the score), the
+ * monitoring interval in seconds (2 bytes, 0 to disable) and the list of candidates. The election
+ * is stopped if the list is empty.
+ */
+void mesh_time_election_start(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length)
+{
+    mesh_time_election_t *p_election = &mesh_time_election;
+    uint8_t num_candidates = p_data[5];
+    uint8_t i;
+
+    // Election in progress is not affected by an invalid command
+    if ((num_candidates > MESH_TIME_ELECTION_MAX_CANDIDATES) || (length < MESH_TIME_ELECTION_START_PARAM_LEN + 2 * (uint32_t)num_candidates))
+    {
+        MESH_TIME_TRACE(ERROR, BAD_LEN, HCI_CONTROL_MESH_COMMAND_TIME_ELECTION_START, length, num_candidates);
+        wiced_bt_mesh_release_event(p_event);
+        return;
+    }
+    wiced_stop_timer(&p_election->timer);
+    p_election->state = MESH_TIME_ELECTION_STATE_IDLE;
+
+    memcpy(&p_election->hdr, p_event, sizeof(wiced_bt_mesh_event_t));
+    wiced_bt_mesh_release_event(p_event);
+
+    STREAM_TO_UINT8(p_election->num_relays, p_data);
+    STREAM_TO_UINT16(p_election->max_score_ms, p_data);
+    STREAM_TO_UINT16(p_election->monitor_interval, p_data);
+    STREAM_TO_UINT8(num_candidates, p_data);
+
+    if (p_election->num_relays > MESH_TIME_ELECTION_MAX_RELAYS)
+        p_election->num_relays = MESH_TIME_ELECTION_MAX_RELAYS;
+
+    p_election->num_candidates = num_candidates;
+    for (i = 0; i < num_candidates; i++)
+    {
+        STREAM_TO_UINT16(p_election->candidate[i].addr, p_data);
+        p_election->candidate[i].role = 0xFF;
+    }
+    if (num_candidates != 0)
+        mesh_time_election_survey();
+}
+
+/*
+ * Send time and role gets to all candidates. Round trip of the time gets is measured by the
+ * server cache and is used for the score.
+ */
+void mesh_time_election_survey(void)
+{
+    mesh_time_election_t *p_election = &mesh_time_election;
+    wiced_bt_mesh_event_t *p_get;
+    uint8_t i;
+
+    MESH_TIME_TRACE(INFO, ELECTION_START, p_election->num_candidates, p_election->num_relays, 0);
+
+    p_election->state = MESH_TIME_ELECTION_STATE_SURVEY;
+    for (i = 0; i < p_election->num_candidates; i++)
+    {
+        p_election->candidate[i].replied = WICED_FALSE;
+        mesh_time_client_time_get_send(&p_election->hdr, p_election->candidate[i].addr);
+
+        if ((p_get = mesh_time_event_copy(&p_election->hdr, p_election->candidate[i].addr)) != NULL)
+            mesh_time_role_get(p_get, NULL, 0);
+    }
+    wiced_start_timer(&p_election->timer, MESH_TIME_ELECTION_SURVEY_TIMEOUT);
+}
+
+/*
+ * Survey is over, or it is time to check the quality of the authority. The election is run again
+ * if the authority has not replied several times, if its score exceeds the configured max or
+ * if no candidate replied to the last survey.
+ */
+void mesh_time_election_timeout(TIMER_PARAM_TYPE arg)
+{
+    mesh_time_election_t *p_election = &mesh_time_election;
+    mesh_time_server_t   *p_server;
+    uint32_t score;
+
+    if (p_election->state == MESH_TIME_ELECTION_STATE_SURVEY)
+    {
+        mesh_time_election_complete();
+        return;
+    }
+    if (p_election->state != MESH_TIME_ELECTION_STATE_MONITOR)
+        return;
+
+    // No candidate replied to the last survey
+    if (p_election->authority == 0)
+    {
+        mesh_time_election_survey();
+        return;
+    }
+
+    p_server = mesh_time_server_find(p_election->authority, MESH_TIME_SERVER_FIND);
+    score = (p_server != NULL) ? mesh_time_server_score(p_server) : 0;
+
+    // The last get has been sent one interval ago, the authority missed it if nothing has been received since
+    if ((p_server == NULL) || (p_server->time_rx_ms < p_election->get_ms))
+        p_election->num_missed++;
+    else
+        p_election->num_missed = 0;
+
+    if ((p_election->num_missed >= MESH_TIME_ELECTION_MAX_MISSED) ||
+        ((p_election->max_score_ms != 0) && (p_server != NULL) && (score > p_election->max_score_ms)))
+    {
+        MESH_TIME_TRACE(INFO, ELECTION_DEGRADED, p_election->authority, score, p_election->num_missed);
+        mesh_time_election_survey();
+        return;
+    }
+    p_election->get_ms = mesh_time_client_get_tick_ms();
+    mesh_time_client_time_get_send(&p_election->hdr, p_election->authority);
+    wiced_start_timer(&p_election->timer, p_election->monitor_interval);
+}
+
+/*
+ * Rank the candidates which replied during the survey. The best one becomes the Time Authority,
+ * the next ones Time Relays and the others Time Clients. The score includes the round trip
+ * delay, so the relays closest to the client are preferred, and the uncertainty reported by
+ * the servers, so the relays add the least uncertainty. Role Set is only sent to the servers
+ * which have a different role.
+ */
+void mesh_time_election_complete(void)
+{
+    mesh_time_election_t *p_election = &mesh_time_election;
+    mesh_time_election_candidate_t *p_candidate;
+    mesh_time_server_t *p_ranking[MESH_TIME_ELECTION_MAX_CANDIDATES];
+    mesh_time_server_t *p_server;
+    uint32_t score[MESH_TIME_ELECTION_MAX_CANDIDATES];
+    uint8_t  role[MESH_TIME_ELECTION_MAX_CANDIDATES];
+    uint8_t  num = 0;
+    int i, j;
+
+    for (i = 0; i < p_election->num_candidates; i++)
+    {
+        p_candidate = &p_election->candidate[i];
+        if (!p_candidate->replied || ((p_server = mesh_time_server_find(p_candidate->addr, MESH_TIME_SERVER_FIND)) == NULL) ||
+            (p_server->num_samples == 0))
+            continue;
+
+        // insertion sort, the number of candidates is small
+        for (j = num; (j > 0) && (score[j - 1] > mesh_time_server_score(p_server)); j--)
+        {
+            score[j] = score[j - 1];
+            p_ranking[j] = p_ranking[j - 1];
+            role[j] = role[j - 1];
+        }
+        score[j] = mesh_time_server_score(p_server);
+        p_ranking[j] = p_server;
+        role[j] = p_candidate->role;
+        num++;
+    }
+    p_election->authority = 0;
+    p_election->num_elected_relays = 0;
+    p_election->num_missed = 0;
+    p_election->get_ms = 0;
+
+    for (i = 0; i < num; i++)
+    {
+        if (i == 0)
+        {
+            p_election->authority = p_ranking[i]->addr;
+            if (role[i] != MESH_TIME_ROLE_AUTHORITY)
+                mesh_time_election_role_set(p_ranking[i]->addr, MESH_TIME_ROLE_AUTHORITY);
+        }
+        else if (i <= p_election->num_relays)
+        {
+            p_election->relay[p_election->num_elected_relays++] = p_ranking[i]->addr;
+            if (role[i] != MESH_TIME_ROLE_RELAY)
+                mesh_time_election_role_set(p_ranking[i]->addr, MESH_TIME_ROLE_RELAY);
+        }
+        else if (role[i] != MESH_TIME_ROLE_CLIENT)
+        {
+            mesh_time_election_role_set(p_ranking[i]->addr, MESH_TIME_ROLE_CLIENT);
+        }
+    }
+    p_election->num_elections++;
+
+    MESH_TIME_TRACE(INFO, ELECTION_RESULT, p_election->authority, p_election->num_elected_relays, num);
+
+    // Without the authority the survey is repeated after the monitoring interval. Without the
+    // monitoring the roles are kept until the next Election Start.
+    if (p_election->monitor_interval != 0)
+    {
+        p_election->state = MESH_TIME_ELECTION_STATE_MONITOR;
+        wiced_start_timer(&p_election->timer, p_election->monitor_interval);
+    }
+    else
+    {
+        p_election->state = MESH_TIME_ELECTION_STATE_IDLE;
+    }
+
+#ifdef HCI_CONTROL
+    mesh_time_election_status_hci_event_send();
+#endif
+}
+
+/*
+ * Send Time Role Set through the pacing queue, the server replies with Time Role Status
+ */
+void mesh_time_election_role_set(uint16_t addr, uint8_t role)
+{
+    wiced_bt_mesh_event_t *p_event;
+
+    if ((p_event = mesh_time_event_copy(&mesh_time_election.hdr, addr)) == NULL)
+    {
+        MESH_TIME_TRACE(ERROR, NO_MEM, HCI_CONTROL_MESH_COMMAND_TIME_ROLE_SET, addr, 0);
+        return;
+    }
+    p_event->reply = 1;
+    mesh_time_pace_send(mesh_time_command_find(HCI_CONTROL_MESH_COMMAND_TIME_ROLE_SET), p_event, &role, sizeof(role));
+}
+
+/*
+ * Record time and role statuses of the candidates. The survey is completed as soon as
+ * all candidates replied.
+ */
+void mesh_time_election_status_process(uint16_t event, uint16_t src, void *p_data)
+{
+    mesh_time_election_t *p_election = &mesh_time_election;
+    mesh_time_election_candidate_t *p_candidate = NULL;
+    uint8_t i;
+
+    for (i = 0; i < p_election->num_candidates; i++)
+    {
+        if (p_election->candidate[i].addr == src)
+        {
+            p_candidate = &p_election->candidate[i];
+            break;
+        }
+    }
+    if (p_candidate == NULL)
+        return;
+
+    if (event == WICED_BT_MESH_TIME_ROLE_STATUS)
+        p_candidate->role = ((wiced_bt_mesh_time_role_msg_t *)p_data)->role;
+    else if (event == WICED_BT_MESH_TIME_STATUS)
+        p_candidate->replied = WICED_TRUE;
+    else
+        return;
+
+    if (p_election->state != MESH_TIME_ELECTION_STATE_SURVEY)
+        return;
+
+    for (i = 0; i < p_election->num_candidates; i++)
+    {
+        if (!p_election->candidate[i].replied || (p_election->candidate[i].role == 0xFF))
+            return;
+    }
+    wiced_stop_timer(&p_election->timer);
+    mesh_time_election_complete();
+}
+
+#if MESH_TIME_CLIENT_CAPTURE
+/*
+ * Start or stop capture of the HCI frames. Starting the capture clears the buffer. The buffer
+ * read by the host can be saved as a file and mapped in memory: it starts with the magic
+ * "MTC1" and the local time of the capture start in milliseconds (4 bytes), followed by the
+ * records. Each record contains the record length including the record header (2 bytes), the
+ * direction (0 - command, 1 - event), the opcode (2 bytes), the local time in milliseconds
+ * (4 bytes) and the frame data. All values are little endian.
+ */
+void mesh_time_capture_set(uint8_t *p_data, uint32_t length)
+{
+    uint8_t *p = mesh_time_capture.buf;
+
+    mesh_time_capture.enabled = (p_data[0] != 0) ? WICED_TRUE : WICED_FALSE;
+    if (mesh_time_capture.enabled)
+    {
+        UINT8_TO_STREAM(p, 'M');
+        UINT8_TO_STREAM(p, 'T');
+        UINT8_TO_STREAM(p, 'C');
+        UINT8_TO_STREAM(p, '1');
+        UINT32_TO_STREAM(p, (uint32_t)mesh_time_client_get_tick_ms());
+        mesh_time_capture.length      = MESH_TIME_CAPTURE_HDR_LEN;
+        mesh_time_capture.num_records = 0;
+        mesh_time_capture.num_dropped = 0;
+    }
+    MESH_TIME_TRACE(INFO, CAPTURE, mesh_time_capture.enabled, mesh_time_capture.num_records, mesh_time_capture.num_dropped);
+}
+
+/*
+ * Record HCI frame. When the buffer is full the capture keeps the first frames and counts
+ * the dropped ones, so that the beginning of the reproduced issue is preserved.
+ */
+void mesh_time_capture_write(uint8_t direction, uint16_t opcode, uint8_t *p_data, uint32_t length)
+{
+    uint8_t *p;
+
+    if (!mesh_time_capture.enabled)
+        return;
+
+    if (MESH_TIME_CAPTURE_RECORD_HDR_LEN + length > (uint32_t)(MESH_TIME_CAPTURE_BUF_SIZE - mesh_time_capture.length))
+    {
+        mesh_time_capture.num_dropped++;
+        return;
+    }
+    p = &mesh_time_capture.buf[mesh_time_capture.length];
+
+    UINT16_TO_STREAM(p, MESH_TIME_CAPTURE_RECORD_HDR_LEN + length);
+    UINT8_TO_STREAM(p, direction);
+    UINT16_TO_STREAM(p, opcode);
+    UINT32_TO_STREAM(p, (uint32_t)mesh_time_client_get_tick_ms());
+    memcpy(p, p_data, length);
+
+    mesh_time_capture.length += (uint16_t)(MESH_TIME_CAPTURE_RECORD_HDR_LEN + length);
+    mesh_time_capture.num_records++;
+}
+#endif
+
+/*
+ * Quality of the server time in milliseconds, the lower the better. Similar to the NTP root
+ * distance: half of the round trip delay, jitter and the uncertainty reported by the server.
+ * Servers which are not Time Authorities are placed behind the ones which are.
+ */
+uint32_t mesh_time_server_score(mesh_time_server_t *p_server)
+{
+    uint32_t score;
+
+    // uncertainty is in 10 ms units
+    score = p_server->delay_ms / 2 + p_server->jitter_ms + (uint32_t)p_server->time.uncertainty * 10;
+    if (!p_server->time.time_authority)
+        score += MESH_TIME_NO_AUTHORITY_PENALTY_MS;
+    return score;
+}
+
+/*
+ * Fill the array with up to max_num best servers which have round trip samples ordered by the
+ * score. The array shall have max_num entries. Returns number of servers in the array.
+ */
+uint8_t mesh_time_server_ranking(mesh_time_server_t **p_ranking, uint8_t max_num)
+{
+    mesh_time_server_t *p_server;
+    uint32_t score[MESH_TIME_CLIENT_MAX_SERVERS];
+    uint32_t server_score;
+    uint8_t  num = 0;
+    int i, j;
+
+    if (max_num > MESH_TIME_CLIENT_MAX_SERVERS)
+        max_num = MESH_TIME_CLIENT_MAX_SERVERS;
+
+    for (i = 0; i < MESH_TIME_CLIENT_MAX_SERVERS; i++)
+    {
+        p_server = &mesh_time_server[i];
+        if ((p_server->addr == 0) || (p_server->num_samples == 0))
+            continue;
+
+        server_score = mesh_time_server_score(p_server);
+
+        // The array is full and the server is not better than the last one
+        if ((num == max_num) && ((max_num == 0) || (score[num - 1] <= server_score)))
+            continue;
+
+        // insertion sort, the number of servers is small. The last server drops out if the array is full.
+        j = (num < max_num) ? num++ : num - 1;
+        for (; (j > 0) && (score[j - 1] > server_score); j--)
+        {
+            score[j] = score[j - 1];
+            p_ranking[j] = p_ranking[j - 1];
+        }
+        score[j] = server_score;
+        p_ranking[j] = p_server;
+    }
+    return num;
+}
+
+/*
+ * Returns the server with the best score among the servers which have round trip samples,
+ * or NULL if there is no such server.
+ */
+mesh_time_server_t *mesh_time_server_best(void)
+{
+    mesh_time_server_t *p_best = NULL;
+    uint32_t best_score = 0;
+    uint32_t score;
+    int i;
+
+    for (i = 0; i < MESH_TIME_CLIENT_MAX_SERVERS; i++)
+    {
+        if ((mesh_time_server[i].addr == 0) || (mesh_time_server[i].num_samples == 0))
+            continue;
+
+        score = mesh_time_server_score(&mesh_time_server[i]);
+        if ((p_best == NULL) || (score < best_score))
+        {
+            p_best     = &mesh_time_server[i];
+            best_score = score;
+        }
+    }
+    return p_best;
+}
+
+/*
+ * Report Time Servers ranking and the offset of the best server to the host
+ */
+void mesh_time_server_ranking_get(uint8_t *p_data, uint32_t length)
+{
+    mesh_time_server_t *ranking[MESH_TIME_CLIENT_MAX_SERVERS];
+    uint8_t num;
+
+    num = mesh_time_server_ranking(ranking, MESH_TIME_RANKING_MAX_REPORT);
+
+    MESH_TIME_TRACE(DEBUG, RANKING, num, 0, 0);
+
+#ifdef HCI_CONTROL
+    mesh_time_server_ranking_hci_event_send(ranking, num);
+    mesh_time_offset_status_hci_event_send(num != 0 ? ranking[0] : NULL);
+#endif
+}
+
+/*
+ * Configure periodic time sync. Header of the command provides the addressing parameters,
+ * the destination in the header is not used. The data contains enable flag, min and max
+ * polling interval in seconds, target accuracy in milliseconds, number of servers and the
+ * list of addresses. Configuration is saved in NVRAM. An invalid configuration is rejected
+ * with MESH_TIME_STATUS_INVALID_PARAM and leaves the running time sync and NVRAM unchanged.
+ */
+void mesh_time_sync_scheduler_set(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint32_t length)
+{
+    mesh_time_sync_config_t config;
+    wiced_result_t result;
+    wiced_bool_t valid;
+    uint8_t i;
+
+    memset(&config, 0, sizeof(mesh_time_sync_config_t));
+    config.element_idx = p_event->element_idx;
+    config.app_key_idx = p_event->app_key_idx;
+    config.ttl         = p_event->ttl;
+    wiced_bt_mesh_release_event(p_event);
+
+    STREAM_TO_UINT8(config.enabled, p_data);
+    STREAM_TO_UINT16(config.min_interval, p_data);
+    STREAM_TO_UINT16(config.max_interval, p_data);
+    STREAM_TO_UINT16(config.target_accuracy, p_data);
+    STREAM_TO_UINT8(config.num_servers, p_data);
+
+    valid = (config.num_servers <= MESH_TIME_SYNC_MAX_SERVERS) &&
+            (length >= MESH_TIME_SYNC_SCHEDULER_SET_PARAM_LEN + 2 * (uint32_t)config.num_servers) &&
+            (!config.enabled || ((config.min_interval != 0) && (config.max_interval >= config.min_interval)));
+    if (!valid)
+    {
+        MESH_TIME_TRACE(ERROR, BAD_LEN, HCI_CONTROL_MESH_COMMAND_TIME_SYNC_SCHEDULER_SET, length, config.num_servers);
+    }
+    else
+    {
+        for (i = 0; i < config.num_servers; i++)
+            STREAM_TO_UINT16(config.server[i], p_data);
+
+        MESH_TIME_TRACE(INFO, SYNC_CONFIG, config.enabled, config.num_servers, 0);
+
+        wiced_stop_timer(&mesh_time_sync.timer);
+        mesh_time_sync.config = config;
+
+        if ((wiced_hal_write_nvram(MESH_TIME_SYNC_CONFIG_NVRAM_ID, sizeof(mesh_time_sync_config_t), (uint8_t *)&config, &result) != sizeof(mesh_time_sync_config_t)) ||
+            (result != WICED_SUCCESS))
+        {
+            MESH_TIME_TRACE(ERROR, NVRAM_FAIL, MESH_TIME_SYNC_CONFIG_NVRAM_ID, result, 0);
+        }
+
+        if (config.enabled && (config.num_servers != 0))
+            mesh_time_sync_start(WICED_TRUE);
+    }
+
+#ifdef HCI_CONTROL
+    mesh_time_sync_scheduler_status_hci_event_send(valid ? MESH_TIME_STATUS_SUCCESS : MESH_TIME_STATUS_INVALID_PARAM);
+#endif
+}
+
+/*
+ * Start periodic time sync with the shortest interval. Servers are polled immediately if
+ * poll_now is set, otherwise after MESH_TIME_SYNC_RESTORE_DELAY.
+ */
+void mesh_time_sync_start(wiced_bool_t poll_now)
+{
+    MESH_TIME_TRACE(INFO, SYNC_START, mesh_time_sync.config.num_servers, 0, 0);
+
+    mesh_time_sync.interval  = mesh_time_sync.config.min_interval;
+    mesh_time_sync.drift_ppb = 0;
+    mesh_time_sync.num_polls = 0;
+    memset(mesh_time_sync.prev_rx_ms, 0, sizeof(mesh_time_sync.prev_rx_ms));
+
+    if (poll_now)
+        mesh_time_sync_timeout(0);
+    else
+        wiced_start_timer(&mesh_time_sync.timer, MESH_TIME_SYNC_RESTORE_DELAY);
+}
+
+/*
+ * Poll all configured servers and restart the timer with the current interval
+ */
+void mesh_time_sync_timeout(TIMER_PARAM_TYPE arg)
+{
+    wiced_bt_mesh_event_t hdr;
+    uint8_t i;
+
+    if (!mesh_time_sync.config.enabled)
+        return;
+
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.element_idx = mesh_time_sync.config.element_idx;
+    hdr.app_key_idx = mesh_time_sync.config.app_key_idx;
+    hdr.ttl         = mesh_time_sync.config.ttl;
+
+    for (i = 0; i < mesh_time_sync.config.num_servers; i++)
+        mesh_time_client_time_get_send(&hdr, mesh_time_sync.config.server[i]);
+
+    mesh_time_sync.num_polls++;
+    wiced_start_timer(&mesh_time_sync.timer, mesh_time_sync.interval);
+}
+
+/*
+ * Measure drift of the local clock from two consecutive replies of a polled server and adapt
+ * the polling interval. The error accumulated over the interval by the drift left after the
+ * frequency correction of the disciplined clock, plus the jitter of the server, is kept below
+ * the target accuracy. The interval is doubled when the error over the
+ * doubled interval is still within half of the target, and halved when the target is exceeded.
+ */
+void mesh_time_sync_status_process(mesh_time_server_t *p_server, uint64_t rx_ms)
+{
+    mesh_time_sample_t *p_sample;
+    uint16_t old_interval = mesh_time_sync.interval;
+    uint32_t error_ms;
+    int64_t  drift;
+    int64_t  offset_change;
+    uint8_t  i;
+
+    if (!mesh_time_sync.config.enabled)
+        return;
+
+    for (i = 0; i < mesh_time_sync.config.num_servers; i++)
+    {
+        if (mesh_time_sync.config.server[i] == p_server->addr)
+            break;
+    }
+    if (i == mesh_time_sync.config.num_servers)
+        return;
+
+    // Last sample added by mesh_time_server_sample_add
+    p_sample = &p_server->sample[(p_server->sample_idx + MESH_TIME_FILTER_SIZE - 1) % MESH_TIME_FILTER_SIZE];
+
+    offset_change = p_sample->offset_ms - mesh_time_sync.prev_offset_ms[i];
+
+    // Offset change of more than MESH_TIME_SYNC_MAX_OFFSET_CHANGE is a step of the server time, not a drift
+    if ((mesh_time_sync.prev_rx_ms[i] != 0) && (rx_ms > mesh_time_sync.prev_rx_ms[i]) &&
+        (offset_change < MESH_TIME_SYNC_MAX_OFFSET_CHANGE) && (offset_change > -MESH_TIME_SYNC_MAX_OFFSET_CHANGE))
+    {
+        // offset change in ms per elapsed ms, in parts per billion
+        drift = (offset_change * 1000000000) / (int64_t)(rx_ms - mesh_time_sync.prev_rx_ms[i]);
+        mesh_time_sync.drift_ppb = (int32_t)drift;
+
+        // The disciplined clock already compensates the estimated frequency error
+        if (mesh_time_clock.valid)
+            drift -= mesh_time_clock.freq_ppb;
+
+        error_ms = (uint32_t)(((drift < 0 ? -drift : drift) * mesh_time_sync.interval) / 1000000) + p_server->jitter_ms;
+        if (error_ms > mesh_time_sync.config.target_accuracy)
+        {
+            mesh_time_sync.interval /= 2;
+            if (mesh_time_sync.interval < mesh_time_sync.config.min_interval)
+                mesh_time_sync.interval = mesh_time_sync.config.min_interval;
+        }
+        else if (2 * error_ms < mesh_time_sync.config.target_accuracy / 2)
+        {
+            mesh_time_sync.interval = (mesh_time_sync.interval > mesh_time_sync.config.max_interval / 2) ?
+                                      mesh_time_sync.config.max_interval : mesh_time_sync.interval * 2;
+        }
+    }
+    mesh_time_sync.prev_offset_ms[i] = p_sample->offset_ms;
+    mesh_time_sync.prev_rx_ms[i]     = rx_ms;
+
+    if (mesh_time_sync.interval != old_interval)
+    {
+        MESH_TIME_TRACE(INFO, SYNC_INTERVAL, mesh_time_sync.interval, mesh_time_sync.drift_ppb, 0);
+#ifdef HCI_CONTROL
+        mesh_time_sync_scheduler_status_hci_event_send(MESH_TIME_STATUS_SUCCESS);
+#endif
+    }
+}
+
+/*
+ * Discipline the local clock with the last round trip sample of the server. Only samples of the
+ * best ranked server with a delay close to the filtered delay are used. Large phase errors are
+ * stepped. Otherwise the phase error is slewed at a limited rate and the frequency error of the
+ * local clock is corrected by a fraction of the error not explained by the pending slew (FLL).
+ */
+void mesh_time_clock_update(mesh_time_server_t *p_server, uint64_t rx_ms)
+{
+    mesh_time_clock_t  *p_clock = &mesh_time_clock;
+    mesh_time_sample_t *p_sample;
+    uint64_t interval_ms;
+    int64_t  server_us;
+    int64_t  error_us;
+    int64_t  freq;
+
+    p_sample = &p_server->sample[(p_server->sample_idx + MESH_TIME_FILTER_SIZE - 1) % MESH_TIME_FILTER_SIZE];
+
+    if ((mesh_time_server_best() != p_server) ||
+        (p_sample->delay_ms > MESH_TIME_CLOCK_MAX_DELAY_FACTOR * p_server->delay_ms + 1))
+        return;
+
+    // TAI time at the reception of the status, assuming symmetric delay. subsecond is in 1/256 second units.
+    server_us = (int64_t)p_server->time.tai_seconds * 1000000 + ((int64_t)p_server->time.subsecond * 1000000) / 256 +
+                (int64_t)p_sample->delay_ms * 500;
+
+    p_clock->source           = p_server->addr;
+    p_clock->uncertainty_ms   = (uint32_t)p_server->time.uncertainty * 10 + p_sample->delay_ms / 2;
+    p_clock->tai_utc_delta    = p_server->time.tai_utc_delta_current;
+    p_clock->time_zone_offset = p_server->time.time_zone_offset_current;
+    p_clock->time_authority   = p_server->time.time_authority;
+    p_clock->num_updates++;
+
+    mesh_time_conversion.tai_utc_delta = p_server->time.tai_utc_delta_current;
+    mesh_time_conversion.zone_offset   = p_server->time.time_zone_offset_current;
+
+    interval_ms = rx_ms - p_clock->ref_tick_ms;
+    error_us = p_clock->valid ? server_us - mesh_time_clock_advance(rx_ms) : 0;
+
+    if (!p_clock->valid || (error_us > MESH_TIME_CLOCK_STEP_THRESHOLD_US) || (error_us < -MESH_TIME_CLOCK_STEP_THRESHOLD_US))
+    {
+        MESH_TIME_TRACE(INFO, CLOCK_STEP, (int32_t)(error_us / 1000), 0, 0);
+        p_clock->ref_tick_ms = rx_ms;
+        p_clock->ref_time_us = server_us;
+        p_clock->phase_us    = 0;
+        p_clock->valid       = WICED_TRUE;
+        p_clock->num_steps++;
+        return;
+    }
+
+    // error in us per ms of interval is 1000 ppm
+    if (interval_ms != 0)
+    {
+        if (interval_ms < MESH_TIME_CLOCK_FLL_MIN_INTERVAL_MS)
+            interval_ms = MESH_TIME_CLOCK_FLL_MIN_INTERVAL_MS;
+        freq = p_clock->freq_ppb + ((error_us - p_clock->phase_us) * 1000000 / (int64_t)interval_ms) / MESH_TIME_CLOCK_FLL_GAIN;
+        if (freq > MESH_TIME_CLOCK_MAX_FREQ_PPB)
+            freq = MESH_TIME_CLOCK_MAX_FREQ_PPB;
+        else if (freq < -MESH_TIME_CLOCK_MAX_FREQ_PPB)
+            freq = -MESH_TIME_CLOCK_MAX_FREQ_PPB;
+        p_clock->freq_ppb = (int32_t)freq;
+    }
+    p_clock->phase_us = error_us;
+
+    MESH_TIME_TRACE(DEBUG, CLOCK_UPDATE, p_server->addr, (int32_t)error_us, p_clock->freq_ppb);
+}
+
+/*
+ * Set the local clock from a Time Status which is not a reply to a get of this node, such as
+ * a status published by a Time Authority or relayed by a friend. Without the round trip the
+ * delay is unknown, so the status is only used while no server has round trip samples. Large
+ * errors are stepped, smaller ones are slewed, the frequency is not corrected.
+ */
+void mesh_time_clock_status_update(mesh_time_server_t *p_server, uint64_t rx_ms)
+{
+    mesh_time_clock_t *p_clock = &mesh_time_clock;
+    int64_t server_us;
+    int64_t error_us;
+
+    if (mesh_time_server_best() != NULL)
+        return;
+
+    // subsecond is in 1/256 second units
+    server_us = (int64_t)p_server->time.tai_seconds * 1000000 + ((int64_t)p_server->time.subsecond * 1000000) / 256;
+
+    p_clock->source           = p_server->addr;
+    p_clock->uncertainty_ms   = (uint32_t)p_server->time.uncertainty * 10;
+    p_clock->tai_utc_delta    = p_server->time.tai_utc_delta_current;
+    p_clock->time_zone_offset = p_server->time.time_zone_offset_current;
+    p_clock->time_authority   = p_server->time.time_authority;
+    p_clock->num_updates++;
+
+    mesh_time_conversion.tai_utc_delta = p_server->time.tai_utc_delta_current;
+    mesh_time_conversion.zone_offset   = p_server->time.time_zone_offset_current;
+
+    error_us = p_clock->valid ? server_us - mesh_time_clock_advance(rx_ms) : 0;
+
+    if (!p_clock->valid || (error_us > MESH_TIME_CLOCK_STEP_THRESHOLD_US) || (error_us < -MESH_TIME_CLOCK_STEP_THRESHOLD_US))
+    {
+        MESH_TIME_TRACE(INFO, CLOCK_STEP, (int32_t)(error_us / 1000), 0, 0);
+        p_clock->ref_tick_ms = rx_ms;
+        p_clock->ref_time_us = server_us;
+        p_clock->phase_us    = 0;
+        p_clock->valid       = WICED_TRUE;
+        p_clock->num_steps++;
+        return;
+    }
+    p_clock->phase_us = error_us;
+
+    MESH_TIME_TRACE(DEBUG, CLOCK_UPDATE, p_server->addr, (int32_t)error_us, p_clock->freq_ppb);
+}
+
+/*
+ * Move the reference point of the disciplined clock to the local time applying the frequency
+ * correction and the phase slew accumulated since the last reference. Returns TAI time in
+ * microseconds at tick_ms.
+ */
+int64_t mesh_time_clock_advance(uint64_t tick_ms)
+{
+    mesh_time_clock_t *p_clock = &mesh_time_clock;
+    int64_t slew_us;
+
+    p_clock->ref_time_us  = mesh_time_clock_at(tick_ms, &slew_us);
+    p_clock->phase_us    -= slew_us;
+    p_clock->ref_tick_ms  = tick_ms;
+    return p_clock->ref_time_us;
+}
+
+/*
+ * TAI time in microseconds of the disciplined clock at the local time without changing the
+ * clock state. Phase slew applied between the reference and tick_ms is returned in p_slew_us.
+ */
+int64_t mesh_time_clock_at(uint64_t tick_ms, int64_t *p_slew_us)
+{
+    mesh_time_clock_t *p_clock = &mesh_time_clock;
+    int64_t elapsed_ms  = (int64_t)(tick_ms - p_clock->ref_tick_ms);
+    int64_t max_slew_us = (elapsed_ms * MESH_TIME_CLOCK_MAX_SLEW_PPM) / 1000;
+    int64_t slew_us     = p_clock->phase_us;
+
+    if (slew_us > max_slew_us)
+        slew_us = max_slew_us;
+    else if (slew_us < -max_slew_us)
+        slew_us = -max_slew_us;
+
+    *p_slew_us = slew_us;
+    return p_clock->ref_time_us + elapsed_ms * 1000 + (elapsed_ms * p_clock->freq_ppb) / 1000000 + slew_us;
+}
+
+/*
+ * Get current mesh time from the disciplined clock. The clock state is read without locking,
+ * the caller runs on the application thread which updates it.
+ */
+wiced_bool_t mesh_time_client_get_time(wiced_bt_mesh_time_state_msg_t *p_time)
+{
+    mesh_time_clock_t *p_clock = &mesh_time_clock;
+    uint64_t tick_ms = mesh_time_client_get_tick_ms();
+    uint64_t uncertainty_ms;
+    int64_t  time_us;
+    int64_t  phase_us;
+
+    if (!p_clock->valid)
+        return WICED_FALSE;
+
+    time_us  = mesh_time_clock_at(tick_ms, &phase_us);
+    phase_us = p_clock->phase_us - phase_us;
+
+    // uncertainty grows with the residual drift and includes the phase error not slewed yet
+    uncertainty_ms = p_clock->uncertainty_ms + ((tick_ms - p_clock->ref_tick_ms) * MESH_TIME_CLOCK_HOLDOVER_PPM) / 1000000 +
+                     (uint64_t)((phase_us < 0 ? -phase_us : phase_us) / 1000);
+
+    p_time->tai_seconds              = (uint64_t)(time_us / 1000000);
+    p_time->subsecond                = (uint8_t)(((time_us % 1000000) * 256) / 1000000);
+    p_time->uncertainty              = (uint8_t)(uncertainty_ms >= 2550 ? 0xFF : uncertainty_ms / 10);
+    p_time->time_authority           = p_clock->time_authority;
+    p_time->tai_utc_delta_current    = p_clock->tai_utc_delta;
+    p_time->time_zone_offset_current = p_clock->time_zone_offset;
+    return WICED_TRUE;
+}
+
+/*
+ * Add scheduled change to the list ordered by TAI. Changes which already took effect according
+ * to the local clock are removed. If the list is full the latest change is dropped.
+ */
+void mesh_time_transition_add(mesh_time_transition_t *p_schedule, uint8_t *p_num, uint64_t tai, uint16_t value)
+{
+    wiced_bt_mesh_time_state_msg_t now;
+    uint8_t i, j;
+
+    if (mesh_time_client_get_time(&now))
+    {
+        for (i = 0; (i < *p_num) && (p_schedule[i].tai <= now.tai_seconds); i++)
+            ;
+        if (i != 0)
+        {
+            memmove(&p_schedule[0], &p_schedule[i], (*p_num - i) * sizeof(mesh_time_transition_t));
+            *p_num -= i;
+        }
+    }
+    for (i = 0; (i < *p_num) && (p_schedule[i].tai < tai); i++)
+        ;
+    if ((i < *p_num) && (p_schedule[i].tai == tai))
+    {
+        p_schedule[i].value = value;
+        return;
+    }
+    if (i == MESH_TIME_SCHEDULE_SIZE)
+        return;
+
+    j = (*p_num < MESH_TIME_SCHEDULE_SIZE) ? (*p_num)++ : MESH_TIME_SCHEDULE_SIZE - 1;
+    for (; j > i; j--)
+        p_schedule[j] = p_schedule[j - 1];
+    p_schedule[i].tai   = tai;
+    p_schedule[i].value = value;
+}
+
+/*
+ * Value in effect at the TAI time, the list is short so the search is bounded
+ */
+uint16_t mesh_time_transition_value(mesh_time_transition_t *p_schedule, uint8_t num, uint64_t tai, uint16_t current)
+{
+    uint8_t i;
+
+    for (i = 0; (i < num) && (p_schedule[i].tai <= tai); i++)
+        current = p_schedule[i].value;
+    return current;
+}
+
+/*
+ * Convert TAI to UTC and local time. Times before 2000-01-01T00:00:00, reached by a small TAI
+ * with the TAI-UTC delta or a negative zone offset, are clamped to it.
+ */
+void mesh_time_client_tai_to_local(uint64_t tai_seconds, mesh_time_client_date_t *p_utc, mesh_time_client_date_t *p_local)
+{
+    mesh_time_conversion_t *p_conv = &mesh_time_conversion;
+    uint16_t delta      = mesh_time_transition_value(p_conv->delta_change, p_conv->num_delta_changes, tai_seconds, p_conv->tai_utc_delta);
+    uint16_t zone       = mesh_time_transition_value(p_conv->zone_change, p_conv->num_zone_changes, tai_seconds, p_conv->zone_offset);
+    uint16_t delta_next = mesh_time_transition_value(p_conv->delta_change, p_conv->num_delta_changes, tai_seconds + 1, delta);
+    wiced_bool_t leap   = WICED_FALSE;
+    int64_t utc         = (int64_t)tai_seconds;
+    int64_t local;
+
+    // The last second before the TAI-UTC delta increases by one is the inserted leap second 23:59:60
+    if (delta_next == delta + 1)
+    {
+        leap = WICED_TRUE;
+        utc--;
+    }
+    utc  -= (int64_t)delta - MESH_TIME_TAI_UTC_DELTA_BIAS;
+    local = utc + ((int64_t)zone - MESH_TIME_ZONE_OFFSET_BIAS) * 15 * 60;
+    if (utc < 0)
+        utc = 0;
+    if (local < 0)
+        local = 0;
+
+    if (p_utc != NULL)
+    {
+        mesh_time_seconds_to_date((uint64_t)utc, &p_conv->utc_day, p_utc);
+        if (leap)
+            p_utc->second++;
+    }
+    if (p_local != NULL)
+    {
+        mesh_time_seconds_to_date((uint64_t)local, &p_conv->local_day, p_local);
+        if (leap)
+            p_local->second++;
+    }
+}
+
+/*
+ * Convert seconds since 2000-01-01T00:00:00 to broken-down time. The calendar date is computed
+ * only when the day differs from the cached one. Hours and minutes are computed with
+ * multiplication by the reciprocal which is exact for the seconds within a day.
+ */
+void mesh_time_seconds_to_date(uint64_t seconds, mesh_time_day_cache_t *p_cache, mesh_time_client_date_t *p_date)
+{
+    uint32_t days, era, doe, yoe, doy, mp, year;
+    uint32_t sod;
+
+    if ((seconds < p_cache->day_start) || (seconds - p_cache->day_start >= MESH_TIME_SECONDS_PER_DAY))
+    {
+        // civil from days, era starts on 0000-03-01
+        days = (uint32_t)(seconds / MESH_TIME_SECONDS_PER_DAY);
+        era  = (days + MESH_TIME_DAYS_0000_03_01_TO_2000_01_01) / 146097;
+        doe  = days + MESH_TIME_DAYS_0000_03_01_TO_2000_01_01 - era * 146097;
+        yoe  = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        doy  = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        mp   = (5 * doy + 2) / 153;
+        year = yoe + era * 400;
+
+        p_cache->date.day     = (uint8_t)(doy - (153 * mp + 2) / 5 + 1);
+        p_cache->date.month   = (uint8_t)(mp < 10 ? mp + 3 : mp - 9);
+        p_cache->date.year    = (uint16_t)(year + (p_cache->date.month <= 2));
+        p_cache->date.weekday = (uint8_t)((days + 6) % 7);      // 2000-01-01 was Saturday
+        p_cache->day_start    = (uint64_t)days * MESH_TIME_SECONDS_PER_DAY;
+    }
+    sod = (uint32_t)(seconds - p_cache->day_start);
+
+    *p_date        = p_cache->date;
+    p_date->hour   = (uint8_t)((sod * 37283) >> 27);                  // sod / 3600
+    sod           -= (uint32_t)p_date->hour * 3600;
+    p_date->minute = (uint8_t)((sod * 34953) >> 21);                  // sod / 60
+    p_date->second = (uint8_t)(sod - (uint32_t)p_date->minute * 60);
+}
+
+/*
+ * Report UTC and local time of the TAI seconds provided by the host, or of the current
+ * time of the local clock if the host does not provide the time
+ */
+void mesh_time_local_time_get(uint8_t *p_data, uint32_t length)
+{
+    wiced_bt_mesh_time_state_msg_t now;
+    uint64_t tai_seconds = 0;
+
+    if (length >= 5)
+        STREAM_TO_UINT40(tai_seconds, p_data);
 
+    if ((tai_seconds == 0) && mesh_time_client_get_time(&now))
+        tai_seconds = now.tai_seconds;
+
+#ifdef HCI_CONTROL
+    mesh_time_local_time_status_hci_event_send(tai_seconds);
+#endif
+}
+
+/*
+ * Write trace record to the ring. Only the writer changes the head and only the reader changes
+ * the tail, so no locking is required. If the ring was empty the drain is scheduled.
+ */
+void mesh_time_trace_write(uint8_t level, uint8_t id, uint32_t arg0, uint32_t arg1, uint32_t arg2)
+{
+    mesh_time_trace_record_t *p_record;
+    uint16_t head = mesh_time_trace.head;
+
+    if ((uint16_t)(head - mesh_time_trace.tail) >= MESH_TIME_TRACE_RING_SIZE)
+    {
+        mesh_time_trace.dropped++;
+        return;
+    }
+    p_record = &mesh_time_trace.record[head & (MESH_TIME_TRACE_RING_SIZE - 1)];
+    p_record->time_ms = (uint32_t)mesh_time_client_get_tick_ms();
+    p_record->id      = id;
+    p_record->level   = level;
+    p_record->arg[0]  = arg0;
+    p_record->arg[1]  = arg1;
+    p_record->arg[2]  = arg2;
+    mesh_time_trace.head = head + 1;
+
+    if ((head == mesh_time_trace.tail) && mesh_time_trace.initialized)
+        wiced_start_timer(&mesh_time_trace.timer, MESH_TIME_TRACE_DRAIN_DELAY);
+}
+
+/*
+ * Drain the trace ring when the message processing is done
+ */
+void mesh_time_trace_drain(TIMER_PARAM_TYPE arg)
+{
+#ifdef HCI_CONTROL
+    while (mesh_time_trace.head != mesh_time_trace.tail)
+    {
+        // Try again later if the transport is out of buffers
+        if (!mesh_time_trace_hci_event_send())
+        {
+            wiced_start_timer(&mesh_time_trace.timer, MESH_TIME_TRACE_DRAIN_DELAY);
+            return;
+        }
+    }
+#else
+    mesh_time_trace_record_t *p_record;
+
+    while (mesh_time_trace.head != mesh_time_trace.tail)
+    {
+        p_record = &mesh_time_trace.record[mesh_time_trace.tail & (MESH_TIME_TRACE_RING_SIZE - 1)];
+        // Format strings are not kept in the device, the record is decoded with mesh_time_client_trace.h
+        WICED_BT_TRACE("time clt trace %u level:%u id:%u args:%x %x %x\n", p_record->time_ms, p_record->level, p_record->id,
+                       p_record->arg[0], p_record->arg[1], p_record->arg[2]);
+        mesh_time_trace.tail++;
+    }
+#endif
+}
+
+#ifdef HCI_CONTROL
+/*
+ * Allocate HCI event from the buffers reserved for the time client, O(1) and without the heap.
+ * The buffer is released by the transport when the event is sent. If the pool could not be
+ * created the event is allocated by the mesh application library, if all its buffers are in
+ * use the event is dropped.
+ */
+wiced_bt_mesh_hci_event_t *mesh_time_hci_event_create(wiced_bt_mesh_event_t *p_event)
+{
+    mesh_time_hci_event_pool_t *p_stats = &mesh_time_hci_event_pool;
+    wiced_bt_mesh_hci_event_t  *p_hci_event;
+    uint8_t in_use;
+
+    if (p_stats->p_pool == NULL)
+        return wiced_bt_mesh_create_hci_event(p_event);
+
+    // Bursts larger than the pool are dropped, the shared buffers of the library are left to the mesh core
+    p_hci_event = (wiced_bt_mesh_hci_event_t *)wiced_transport_allocate_buffer(p_stats->p_pool);
+    if (p_hci_event == NULL)
+    {
+        p_stats->num_alloc_fail++;
+        MESH_TIME_TRACE(ERROR, NO_MEM, 0, p_event->src, p_stats->num_alloc_fail);
+        return NULL;
+    }
+    p_stats->num_alloc++;
+    in_use = (uint8_t)(MESH_TIME_HCI_EVENT_POOL_COUNT - wiced_transport_get_buffer_count(p_stats->p_pool));
+    if (in_use > p_stats->high_water)
+        p_stats->high_water = in_use;
+
+    p_hci_event->src         = p_event->src;
+    p_hci_event->app_key_idx = p_event->app_key_idx;
+    p_hci_event->element_idx = p_event->element_idx;
+    return p_hci_event;
+}
+#endif
+
+/*
+ * Local time in milliseconds used to timestamp time client messages
+ */
+uint64_t mesh_time_client_get_tick_ms(void)
+{
+    return wiced_bt_mesh_core_get_tick_count();
+}
+
+/*
+ * Serialize Time state in the format used by the HCI events
+ */
+uint8_t *mesh_time_state_to_stream(uint8_t *p, wiced_bt_mesh_time_state_msg_t *p_time_status)
+{
     UINT40_TO_STREAM(p, p_time_status->tai_seconds);
     UINT8_TO_STREAM(p, p_time_status->subsecond);
     UINT8_TO_STREAM(p, p_time_status->uncertainty);
     UINT8_TO_STREAM(p, p_time_status->time_authority);
     UINT16_TO_STREAM(p, p_time_status->tai_utc_delta_current);
     UINT8_TO_STREAM(p, p_time_status->time_zone_offset_current);
+    return p;
+}
 
-    WICED_BT_TRACE("TAI_seconds: %x\n", p_time_status->tai_seconds);
-    WICED_BT_TRACE("subsecond: %x\n", p_time_status->subsecond);
-    WICED_BT_TRACE("uncertainty: %x\n", p_time_status->uncertainty);
-    WICED_BT_TRACE("auth: %x\n", p_time_status->time_authority);
-    WICED_BT_TRACE("tai_utc_delta_current: %x\n", p_time_status->tai_utc_delta_current);
-    WICED_BT_TRACE("time_zone_offset_current: %x\n",p_time_status->time_zone_offset_current);
+#ifdef HCI_CONTROL
+/*
+ * Send Time Status event over transport
+ */
+void mesh_time_status_hci_event_send(wiced_bt_mesh_hci_event_t *p_hci_event, wiced_bt_mesh_time_state_msg_t *p_time_status)
+{
+    uint8_t *p = p_hci_event->data;
+
+    p = mesh_time_state_to_stream(p, p_time_status);
 
-    mesh_transport_send_data(HCI_CONTROL_MESH_EVENT_TIME_STATUS, (uint8_t *)p_hci_event, (uint16_t)(p - (uint8_t *)p_hci_event));
+    MESH_TIME_TRACE(DEBUG, TIME_STATUS, p_time_status->tai_seconds, p_time_status->subsecond, p_time_status->uncertainty);
+    MESH_TIME_TRACE(DEBUG, TIME_STATUS_EXT, p_time_status->time_authority, p_time_status->tai_utc_delta_current, p_time_status->time_zone_offset_current);
+
+    mesh_time_transport_send(HCI_CONTROL_MESH_EVENT_TIME_STATUS, (uint8_t *)p_hci_event, (uint16_t)(p - (uint8_t *)p_hci_event));
 }
 
 /*
@@ -453,18 +3865,13 @@ void mesh_time_zone_status_hci_event_send(wiced_bt_mesh_hci_event_t *p_hci_event
 {
     uint8_t *p = p_hci_event->data;
 
-    WICED_BT_TRACE("%s\n", __FUNCTION__);
-
     UINT8_TO_STREAM(p, p_time_status->time_zone_offset_current);
     UINT8_TO_STREAM(p, p_time_status->time_zone_offset_new);
     UINT40_TO_STREAM(p, p_time_status->tai_of_zone_change);
 
-    WICED_BT_TRACE(" TAI_of_zone_change:\n");
-    WICED_BT_TRACE("TAI_of_zone_change: %x\n", p_time_status->tai_of_zone_change);
-    WICED_BT_TRACE("time_zone_offset_current: %x\n", p_time_status->time_zone_offset_current);
-    WICED_BT_TRACE("time_zone_offset_new: %x\n",p_time_status->time_zone_offset_new);
+    MESH_TIME_TRACE(DEBUG, ZONE_STATUS, p_time_status->time_zone_offset_current, p_time_status->time_zone_offset_new, p_time_status->tai_of_zone_change);
 
-    mesh_transport_send_data(HCI_CONTROL_MESH_EVENT_TIME_ZONE_STATUS, (uint8_t *)p_hci_event, (uint16_t)(p - (uint8_t *)p_hci_event));
+    mesh_time_transport_send(HCI_CONTROL_MESH_EVENT_TIME_ZONE_STATUS, (uint8_t *)p_hci_event, (uint16_t)(p - (uint8_t *)p_hci_event));
 }
 
 
@@ -475,18 +3882,13 @@ void mesh_time_tai_utc_delta_status_hci_event_send(wiced_bt_mesh_hci_event_t *p_
 {
     uint8_t *p = p_hci_event->data;
 
-    WICED_BT_TRACE("%s\n", __FUNCTION__);
-
     UINT16_TO_STREAM(p, p_time_delta_status->tai_utc_delta_current);
     UINT16_TO_STREAM(p, p_time_delta_status->tai_utc_delta_new);
     UINT40_TO_STREAM(p, p_time_delta_status->tai_of_delta_change);
 
-    WICED_BT_TRACE(" tai_of_delta_change:\n");
-    WICED_BT_TRACE("tai_of_delta_change: %x\n", p_time_delta_status->tai_of_delta_change);
-    WICED_BT_TRACE("tai_utc_delta_current: %x\n", p_time_delta_status->tai_utc_delta_current);
-    WICED_BT_TRACE("tai_utc_delta_new: %x\n",p_time_delta_status->tai_utc_delta_new);
+    MESH_TIME_TRACE(DEBUG, DELTA_STATUS, p_time_delta_status->tai_utc_delta_current, p_time_delta_status->tai_utc_delta_new, p_time_delta_status->tai_of_delta_change);
 
-    mesh_transport_send_data(HCI_CONTROL_MESH_EVENT_TIME_TAI_UTC_DELTA_STATUS, (uint8_t *)p_hci_event, (uint16_t)(p - (uint8_t *)p_hci_event));
+    mesh_time_transport_send(HCI_CONTROL_MESH_EVENT_TIME_TAI_UTC_DELTA_STATUS, (uint8_t *)p_hci_event, (uint16_t)(p - (uint8_t *)p_hci_event));
 }
 
 /*
@@ -496,10 +3898,545 @@ void mesh_time_role_status_hci_event_send(wiced_bt_mesh_hci_event_t *p_hci_event
 {
     uint8_t *p = p_hci_event->data;
 
-    WICED_BT_TRACE("%s role:%x\n", __FUNCTION__, p_role_status->role);
+    MESH_TIME_TRACE(DEBUG, ROLE_STATUS, p_role_status->role, 0, 0);
 
     UINT8_TO_STREAM(p, p_role_status->role);
 
-    mesh_transport_send_data(HCI_CONTROL_MESH_EVENT_TIME_ROLE_STATUS, (uint8_t *)p_hci_event, (uint16_t)(p - (uint8_t *)p_hci_event));
+    mesh_time_transport_send(HCI_CONTROL_MESH_EVENT_TIME_ROLE_STATUS, (uint8_t *)p_hci_event, (uint16_t)(p - (uint8_t *)p_hci_event));
+}
+
+/*
+ * Send part of the batch get results over transport. Event contains total number of servers
+ * in the batch, index of the first reported server and number of servers in this event followed
+ * by the address, reply flag and Time Status of each server.
+ */
+void mesh_time_batch_status_hci_event_send(uint16_t first, uint16_t count)
+{
+    wiced_bt_mesh_hci_event_t *p_hci_event;
+    mesh_time_batch_entry_t   *p_entry;
+    uint8_t *p;
+    uint16_t i;
+
+    if ((p_hci_event = mesh_time_hci_event_create(&mesh_time_batch.hdr)) == NULL)
+    {
+        MESH_TIME_TRACE(ERROR, NO_MEM, HCI_CONTROL_MESH_EVENT_TIME_GET_BATCH_STATUS, 0, 0);
+        return;
+    }
+    p = p_hci_event->data;
+
+    UINT8_TO_STREAM(p, mesh_time_batch.num_dst);
+    UINT8_TO_STREAM(p, first);
+    UINT8_TO_STREAM(p, count);
+    for (i = 0; i < count; i++)
+    {
+        p_entry = &mesh_time_batch.entry[first + i];
+        UINT16_TO_STREAM(p, p_entry->dst);
+        UINT8_TO_STREAM(p, p_entry->replied);
+        if (p_entry->replied)
+            memcpy(p, p_entry->state, MESH_TIME_STATE_MSG_LEN);
+        else
+            memset(p, 0, MESH_TIME_STATE_MSG_LEN);
+        p += MESH_TIME_STATE_MSG_LEN;
+    }
+    mesh_time_transport_send(HCI_CONTROL_MESH_EVENT_TIME_GET_BATCH_STATUS, (uint8_t *)p_hci_event, (uint16_t)(p - (uint8_t *)p_hci_event));
+}
+
+/*
+ * Send Time Servers ranking over transport. For each server the event contains the address,
+ * score, round trip delay and jitter in milliseconds, uncertainty and time authority.
+ */
+void mesh_time_server_ranking_hci_event_send(mesh_time_server_t **p_ranking, uint8_t num)
+{
+    wiced_bt_mesh_hci_event_t *p_hci_event;
+    uint8_t *p;
+    uint8_t  i;
+
+    if ((p_hci_event = mesh_time_hci_event_create(&mesh_time_client_local_hdr)) == NULL)
+        return;
+
+    p = p_hci_event->data;
+
+    UINT8_TO_STREAM(p, num);
+    for (i = 0; i < num; i++)
+    {
+        UINT16_TO_STREAM(p, p_ranking[i]->addr);
+        UINT32_TO_STREAM(p, mesh_time_server_score(p_ranking[i]));
+        UINT32_TO_STREAM(p, p_ranking[i]->delay_ms);
+        UINT32_TO_STREAM(p, p_ranking[i]->jitter_ms);
+        UINT8_TO_STREAM(p, p_ranking[i]->time.uncertainty);
+        UINT8_TO_STREAM(p, p_ranking[i]->time.time_authority);
+    }
+    mesh_time_transport_send(HCI_CONTROL_MESH_EVENT_TIME_SERVER_RANKING, (uint8_t *)p_hci_event, (uint16_t)(p - (uint8_t *)p_hci_event));
+}
+
+/*
+ * Send filtered offset of the best server over transport. The event contains the server
+ * address (0 if no server has been measured), 64 bit offset of the server time in milliseconds
+ * relative to the local time, round trip delay and jitter.
+ */
+void mesh_time_offset_status_hci_event_send(mesh_time_server_t *p_server)
+{
+    wiced_bt_mesh_hci_event_t *p_hci_event;
+    uint8_t *p;
+    uint64_t offset = (p_server != NULL) ? (uint64_t)p_server->offset_ms : 0;
+
+    if ((p_hci_event = mesh_time_hci_event_create(&mesh_time_client_local_hdr)) == NULL)
+        return;
+
+    p = p_hci_event->data;
+
+    UINT16_TO_STREAM(p, (p_server != NULL) ? p_server->addr : 0);
+    UINT32_TO_STREAM(p, (uint32_t)offset);
+    UINT32_TO_STREAM(p, (uint32_t)(offset >> 32));
+    UINT32_TO_STREAM(p, (p_server != NULL) ? p_server->delay_ms : 0);
+    UINT32_TO_STREAM(p, (p_server != NULL) ? p_server->jitter_ms : 0);
+
+    mesh_time_transport_send(HCI_CONTROL_MESH_EVENT_TIME_OFFSET_STATUS, (uint8_t *)p_hci_event, (uint16_t)(p - (uint8_t *)p_hci_event));
+}
+
+/*
+ * Send state of the periodic time sync over transport: enabled flag, number of servers,
+ * current polling interval in seconds, measured drift in ppb, number of polls and the
+ * status of the last configuration (MESH_TIME_STATUS_XXX).
+ */
+void mesh_time_sync_scheduler_status_hci_event_send(uint8_t status)
+{
+    wiced_bt_mesh_hci_event_t *p_hci_event;
+    uint8_t *p;
+
+    if ((p_hci_event = mesh_time_hci_event_create(&mesh_time_client_local_hdr)) == NULL)
+        return;
+
+    p = p_hci_event->data;
+
+    UINT8_TO_STREAM(p, mesh_time_sync.config.enabled);
+    UINT8_TO_STREAM(p, mesh_time_sync.config.num_servers);
+    UINT16_TO_STREAM(p, mesh_time_sync.interval);
+    UINT32_TO_STREAM(p, (uint32_t)mesh_time_sync.drift_ppb);
+    UINT32_TO_STREAM(p, mesh_time_sync.num_polls);
+    UINT8_TO_STREAM(p, status);
+
+    mesh_time_transport_send(HCI_CONTROL_MESH_EVENT_TIME_SYNC_SCHEDULER_STATUS, (uint8_t *)p_hci_event, (uint16_t)(p - (uint8_t *)p_hci_event));
+}
+
+/*
+ * Send mesh time of the local clock over transport: valid flag and Time Status fields
+ * followed by the time source address and the estimated frequency error in ppb.
+ */
+void mesh_time_now_status_hci_event_send(void)
+{
+    wiced_bt_mesh_hci_event_t *p_hci_event;
+    wiced_bt_mesh_time_state_msg_t time_now;
+    wiced_bool_t valid;
+    uint8_t *p;
+
+    memset(&time_now, 0, sizeof(time_now));
+    valid = mesh_time_client_get_time(&time_now);
+
+    if ((p_hci_event = mesh_time_hci_event_create(&mesh_time_client_local_hdr)) == NULL)
+        return;
+
+    p = p_hci_event->data;
+
+    UINT8_TO_STREAM(p, valid);
+    p = mesh_time_state_to_stream(p, &time_now);
+    UINT16_TO_STREAM(p, mesh_time_clock.source);
+    UINT32_TO_STREAM(p, (uint32_t)mesh_time_clock.freq_ppb);
+
+    mesh_time_transport_send(HCI_CONTROL_MESH_EVENT_TIME_NOW_STATUS, (uint8_t *)p_hci_event, (uint16_t)(p - (uint8_t *)p_hci_event));
+}
+
+/*
+ * Send Local Time Status event over transport: TAI seconds followed by UTC and local time,
+ * each as year, month, day, hour, minute, second and weekday.
+ */
+void mesh_time_local_time_status_hci_event_send(uint64_t tai_seconds)
+{
+    wiced_bt_mesh_hci_event_t *p_hci_event;
+    mesh_time_client_date_t date[2];
+    uint8_t *p;
+    int i;
+
+    mesh_time_client_tai_to_local(tai_seconds, &date[0], &date[1]);
+
+    if ((p_hci_event = mesh_time_hci_event_create(&mesh_time_client_local_hdr)) == NULL)
+        return;
+
+    p = p_hci_event->data;
+
+    UINT40_TO_STREAM(p, tai_seconds);
+    for (i = 0; i < 2; i++)
+    {
+        UINT16_TO_STREAM(p, date[i].year);
+        UINT8_TO_STREAM(p, date[i].month);
+        UINT8_TO_STREAM(p, date[i].day);
+        UINT8_TO_STREAM(p, date[i].hour);
+        UINT8_TO_STREAM(p, date[i].minute);
+        UINT8_TO_STREAM(p, date[i].second);
+        UINT8_TO_STREAM(p, date[i].weekday);
+    }
+    mesh_time_transport_send(HCI_CONTROL_MESH_EVENT_LOCAL_TIME_STATUS, (uint8_t *)p_hci_event, (uint16_t)(p - (uint8_t *)p_hci_event));
+}
+
+/*
+ * Send trace records from the ring over transport. The format of the event is described in
+ * mesh_time_client_trace.h. Returns WICED_FALSE if the event could not be allocated.
+ */
+wiced_bool_t mesh_time_trace_hci_event_send(void)
+{
+    wiced_bt_mesh_hci_event_t *p_hci_event;
+    mesh_time_trace_record_t  *p_record;
+    uint8_t *p;
+    uint8_t *p_num;
+    uint8_t  num = 0;
+
+    if ((p_hci_event = mesh_time_hci_event_create(&mesh_time_client_local_hdr)) == NULL)
+        return WICED_FALSE;
+
+    p = p_hci_event->data;
+    p_num = p++;
+    UINT16_TO_STREAM(p, mesh_time_trace.dropped);
+    mesh_time_trace.dropped = 0;
+
+    while ((mesh_time_trace.head != mesh_time_trace.tail) && (num < MESH_TIME_TRACE_RECORDS_PER_EVENT))
+    {
+        p_record = &mesh_time_trace.record[mesh_time_trace.tail & (MESH_TIME_TRACE_RING_SIZE - 1)];
+        UINT32_TO_STREAM(p, p_record->time_ms);
+        UINT8_TO_STREAM(p, p_record->id);
+        UINT8_TO_STREAM(p, p_record->level);
+        UINT32_TO_STREAM(p, p_record->arg[0]);
+        UINT32_TO_STREAM(p, p_record->arg[1]);
+        UINT32_TO_STREAM(p, p_record->arg[2]);
+        mesh_time_trace.tail++;
+        num++;
+    }
+    *p_num = num;
+
+    mesh_time_transport_send(HCI_CONTROL_MESH_EVENT_TIME_CLIENT_TRACE, (uint8_t *)p_hci_event, (uint16_t)(p - (uint8_t *)p_hci_event));
+    return WICED_TRUE;
+}
+
+/*
+ * Send allocation statistics over transport: HCI event pool size, buffers in use, high-water
+ * mark, number of allocations and failures, number of mesh events created from the HCI commands
+ * and failures, pending request pool size, high-water mark and number of untracked gets.
+ */
+void mesh_time_pool_stats_hci_event_send(void)
+{
+    mesh_time_hci_event_pool_t *p_stats = &mesh_time_hci_event_pool;
+    wiced_bt_mesh_hci_event_t  *p_hci_event;
+    uint8_t *p;
+    uint8_t  in_use = 0;
+
+    if ((p_hci_event = mesh_time_hci_event_create(&mesh_time_client_local_hdr)) == NULL)
+        return;
+
+    if (p_stats->p_pool != NULL)
+        in_use = (uint8_t)(MESH_TIME_HCI_EVENT_POOL_COUNT - wiced_transport_get_buffer_count(p_stats->p_pool));
+
+    p = p_hci_event->data;
+
+    UINT8_TO_STREAM(p, MESH_TIME_HCI_EVENT_POOL_COUNT);
+    UINT8_TO_STREAM(p, in_use);
+    UINT8_TO_STREAM(p, p_stats->high_water);
+    UINT32_TO_STREAM(p, p_stats->num_alloc);
+    UINT32_TO_STREAM(p, p_stats->num_alloc_fail);
+    UINT32_TO_STREAM(p, p_stats->num_cmd_alloc);
+    UINT32_TO_STREAM(p, p_stats->num_cmd_alloc_fail);
+    UINT8_TO_STREAM(p, MESH_TIME_REQUEST_POOL_SIZE);
+    UINT8_TO_STREAM(p, mesh_time_request.high_water);
+    UINT32_TO_STREAM(p, mesh_time_request.num_untracked);
+
+    mesh_time_transport_send(HCI_CONTROL_MESH_EVENT_TIME_CLIENT_POOL_STATS, (uint8_t *)p_hci_event, (uint16_t)(p - (uint8_t *)p_hci_event));
+}
+
+/*
+ * Send message statistics over transport: number of unknown events, unknown commands, commands
+ * with bad mesh header and unsolicited statuses, followed by the number of commands and for each
+ * command the opcode, number of commands, retries, replies, lost commands and the round trip
+ * histogram. This is the largest time client event, it sets MESH_TIME_HCI_EVENT_POOL_BUF_SIZE.
+ */
+void mesh_time_stats_hci_event_send(void)
+{
+    mesh_time_opcode_stats_t  *p_opcode;
+    wiced_bt_mesh_hci_event_t *p_hci_event;
+    uint8_t *p;
+    int i, j;
+
+    if ((p_hci_event = mesh_time_hci_event_create(&mesh_time_client_local_hdr)) == NULL)
+        return;
+
+    p = p_hci_event->data;
+
+    UINT32_TO_STREAM(p, mesh_time_stats.num_unknown_event);
+    UINT32_TO_STREAM(p, mesh_time_stats.num_unknown_cmd);
+    UINT32_TO_STREAM(p, mesh_time_stats.num_bad_hdr);
+    UINT32_TO_STREAM(p, mesh_time_stats.num_unsolicited);
+    UINT8_TO_STREAM(p, MESH_TIME_STATS_NUM_OPCODES);
+    for (i = 0; i < MESH_TIME_STATS_NUM_OPCODES; i++)
+    {
+        p_opcode = &mesh_time_stats.opcode[i];
+        UINT16_TO_STREAM(p, mesh_time_stats_opcode[i]);
+        UINT32_TO_STREAM(p, p_opcode->num_cmd);
+        UINT32_TO_STREAM(p, p_opcode->num_retry);
+        UINT32_TO_STREAM(p, p_opcode->num_reply);
+        UINT32_TO_STREAM(p, p_opcode->num_lost);
+        for (j = 0; j < MESH_TIME_STATS_NUM_BUCKETS; j++)
+            UINT16_TO_STREAM(p, p_opcode->rtt_hist[j]);
+    }
+    mesh_time_transport_send(HCI_CONTROL_MESH_EVENT_TIME_CLIENT_STATS, (uint8_t *)p_hci_event, (uint16_t)(p - (uint8_t *)p_hci_event));
+}
+
+/*
+ * Send destination statistics over transport: number of destinations and for each one the
+ * address, number of commands, replies, lost commands, smoothed and max round trip time.
+ */
+void mesh_time_dst_stats_hci_event_send(void)
+{
+    mesh_time_dst_stats_t     *p_dst;
+    wiced_bt_mesh_hci_event_t *p_hci_event;
+    uint8_t *p;
+    uint8_t *p_num_dst;
+    uint8_t  num_dst = 0;
+    int i;
+
+    if ((p_hci_event = mesh_time_hci_event_create(&mesh_time_client_local_hdr)) == NULL)
+        return;
+
+    p = p_hci_event->data;
+    p_num_dst = p++;
+
+    for (i = 0; i < MESH_TIME_STATS_NUM_DST; i++)
+    {
+        p_dst = &mesh_time_stats.dst[i];
+        if (p_dst->addr == 0)
+            continue;
+        UINT16_TO_STREAM(p, p_dst->addr);
+        UINT32_TO_STREAM(p, p_dst->num_cmd);
+        UINT32_TO_STREAM(p, p_dst->num_reply);
+        UINT32_TO_STREAM(p, p_dst->num_lost);
+        UINT16_TO_STREAM(p, p_dst->srtt_ms);
+        UINT16_TO_STREAM(p, p_dst->max_rtt_ms);
+        num_dst++;
+    }
+    *p_num_dst = num_dst;
+
+    mesh_time_transport_send(HCI_CONTROL_MESH_EVENT_TIME_CLIENT_DST_STATS, (uint8_t *)p_hci_event, (uint16_t)(p - (uint8_t *)p_hci_event));
+}
+
+/*
+ * Send Command Batch Status event over transport: number of sub-commands processed, the bitmap
+ * of the sub-commands which have been sent and the bitmap of the sub-commands which wait in the
+ * pacing queue. Bit 0 of the first byte of each bitmap is the first sub-command.
+ */
+void mesh_time_command_batch_status_hci_event_send(uint8_t num_cmd, uint8_t *p_ack, uint8_t *p_queued)
+{
+    wiced_bt_mesh_hci_event_t *p_hci_event;
+    uint8_t *p;
+
+    if ((p_hci_event = mesh_time_hci_event_create(&mesh_time_client_local_hdr)) == NULL)
+        return;
+
+    p = p_hci_event->data;
+
+    UINT8_TO_STREAM(p, num_cmd);
+    memcpy(p, p_ack, (num_cmd + 7) / 8);
+    p += (num_cmd + 7) / 8;
+    memcpy(p, p_queued, (num_cmd + 7) / 8);
+    p += (num_cmd + 7) / 8;
+
+    mesh_time_transport_send(HCI_CONTROL_MESH_EVENT_TIME_COMMAND_BATCH_STATUS, (uint8_t *)p_hci_event, (uint16_t)(p - (uint8_t *)p_hci_event));
+}
+
+/*
+ * Send Pacing Status event over transport: rate, max burst, max jitter in milliseconds (2 bytes),
+ * queue size, number of messages in the queue, high-water mark, number of messages queued,
+ * sent and dropped.
+ */
+void mesh_time_pace_status_hci_event_send(void)
+{
+    wiced_bt_mesh_hci_event_t *p_hci_event;
+    uint8_t *p;
+
+    if ((p_hci_event = mesh_time_hci_event_create(&mesh_time_client_local_hdr)) == NULL)
+        return;
+
+    p = p_hci_event->data;
+
+    UINT8_TO_STREAM(p, mesh_time_pace.rate);
+    UINT8_TO_STREAM(p, mesh_time_pace.burst);
+    UINT16_TO_STREAM(p, mesh_time_pace.jitter_ms);
+    UINT8_TO_STREAM(p, MESH_TIME_PACE_QUEUE_SIZE);
+    UINT8_TO_STREAM(p, mesh_time_pace.depth);
+    UINT8_TO_STREAM(p, mesh_time_pace.high_water);
+    UINT32_TO_STREAM(p, mesh_time_pace.num_queued);
+    UINT32_TO_STREAM(p, mesh_time_pace.num_sent);
+    UINT32_TO_STREAM(p, mesh_time_pace.num_dropped);
+
+    mesh_time_transport_send(HCI_CONTROL_MESH_EVENT_TIME_PACING_STATUS, (uint8_t *)p_hci_event, (uint16_t)(p - (uint8_t *)p_hci_event));
+}
+
+#if LOW_POWER_NODE
+/*
+ * Send Low Power Node Status event over transport: deferral enabled, number of deferred gets,
+ * number of sleep periods, gets deferred, radio activities started by the time client, Time
+ * Status messages received, on-time in milliseconds, on-time per sync in milliseconds and radio
+ * activities per sync in 1/100 units.
+ */
+void mesh_time_lpn_status_hci_event_send(void)
+{
+    wiced_bt_mesh_hci_event_t *p_hci_event;
+    uint32_t num_syncs = (mesh_time_lpn.num_syncs != 0) ? mesh_time_lpn.num_syncs : 1;
+    uint8_t *p;
+
+    if ((p_hci_event = mesh_time_hci_event_create(&mesh_time_client_local_hdr)) == NULL)
+        return;
+
+    p = p_hci_event->data;
+
+    UINT8_TO_STREAM(p, mesh_time_lpn.enabled);
+    UINT8_TO_STREAM(p, mesh_time_lpn.depth);
+    UINT32_TO_STREAM(p, mesh_time_lpn.num_sleep);
+    UINT32_TO_STREAM(p, mesh_time_lpn.num_deferred);
+    UINT32_TO_STREAM(p, mesh_time_lpn.num_tx_wakeups);
+    UINT32_TO_STREAM(p, mesh_time_lpn.num_syncs);
+    UINT32_TO_STREAM(p, mesh_time_lpn.on_time_ms);
+    UINT32_TO_STREAM(p, mesh_time_lpn.on_time_ms / num_syncs);
+    UINT32_TO_STREAM(p, (uint32_t)(((uint64_t)mesh_time_lpn.num_tx_wakeups * 100) / num_syncs));
+
+    mesh_time_transport_send(HCI_CONTROL_MESH_EVENT_TIME_LPN_STATUS, (uint8_t *)p_hci_event, (uint16_t)(p - (uint8_t *)p_hci_event));
+}
+#endif
+
+#if !LOW_POWER_NODE
+/*
+ * Send Proxy Status event over transport: number of polls between updates (2 bytes), number of
+ * updates skipped because the local time is not known, number of Low Power Nodes and for each
+ * node the address, poll interval in milliseconds and number of updates sent.
+ */
+void mesh_time_proxy_status_hci_event_send(void)
+{
+    wiced_bt_mesh_hci_event_t *p_hci_event;
+    uint8_t *p;
+    uint8_t  i;
+
+    if ((p_hci_event = mesh_time_hci_event_create(&mesh_time_client_local_hdr)) == NULL)
+        return;
+
+    p = p_hci_event->data;
+
+    UINT16_TO_STREAM(p, mesh_time_proxy.update_polls);
+    UINT32_TO_STREAM(p, mesh_time_proxy.num_skipped);
+    UINT8_TO_STREAM(p, mesh_time_proxy.num_lpn);
+    for (i = 0; i < mesh_time_proxy.num_lpn; i++)
+    {
+        UINT16_TO_STREAM(p, mesh_time_proxy.lpn[i].addr);
+        UINT32_TO_STREAM(p, mesh_time_proxy.lpn[i].poll_interval_ms);
+        UINT32_TO_STREAM(p, mesh_time_proxy.lpn[i].num_updates);
+    }
+    mesh_time_transport_send(HCI_CONTROL_MESH_EVENT_TIME_PROXY_STATUS, (uint8_t *)p_hci_event, (uint16_t)(p - (uint8_t *)p_hci_event));
+}
+#endif
+
+/*
+ * Send Election Status event over transport: state, number of completed elections, Time Authority
+ * address (0 if none), number of Time Relays and their addresses.
+ */
+void mesh_time_election_status_hci_event_send(void)
+{
+    wiced_bt_mesh_hci_event_t *p_hci_event;
+    uint8_t *p;
+    uint8_t  i;
+
+    if ((p_hci_event = mesh_time_hci_event_create(&mesh_time_client_local_hdr)) == NULL)
+        return;
+
+    p = p_hci_event->data;
+
+    UINT8_TO_STREAM(p, mesh_time_election.state);
+    UINT32_TO_STREAM(p, mesh_time_election.num_elections);
+    UINT16_TO_STREAM(p, mesh_time_election.authority);
+    UINT8_TO_STREAM(p, mesh_time_election.num_elected_relays);
+    for (i = 0; i < mesh_time_election.num_elected_relays; i++)
+        UINT16_TO_STREAM(p, mesh_time_election.relay[i]);
+
+    mesh_time_transport_send(HCI_CONTROL_MESH_EVENT_TIME_ELECTION_STATUS, (uint8_t *)p_hci_event, (uint16_t)(p - (uint8_t *)p_hci_event));
+}
+
+#if MESH_TIME_CLIENT_CAPTURE
+/*
+ * Send block of the capture buffer over transport. The command data contains the offset in the
+ * buffer (2 bytes). The event contains capture enabled flag, number of records (2 bytes), number
+ * of dropped frames (2 bytes), length of the captured data (2 bytes), offset of the block
+ * (2 bytes) and the block.
+ */
+void mesh_time_capture_data_hci_event_send(uint8_t *p_data, uint32_t length)
+{
+    wiced_bt_mesh_hci_event_t *p_hci_event;
+    uint16_t offset = 0;
+    uint16_t len;
+    uint8_t *p;
+
+    if (length >= 2)
+        STREAM_TO_UINT16(offset, p_data);
+    if (offset > mesh_time_capture.length)
+        offset = mesh_time_capture.length;
+
+    len = mesh_time_capture.length - offset;
+    if (len > MESH_TIME_CAPTURE_DATA_PER_EVENT)
+        len = MESH_TIME_CAPTURE_DATA_PER_EVENT;
+
+    if ((p_hci_event = mesh_time_hci_event_create(&mesh_time_client_local_hdr)) == NULL)
+        return;
+
+    p = p_hci_event->data;
+
+    UINT8_TO_STREAM(p, mesh_time_capture.enabled);
+    UINT16_TO_STREAM(p, mesh_time_capture.num_records);
+    UINT16_TO_STREAM(p, mesh_time_capture.num_dropped);
+    UINT16_TO_STREAM(p, mesh_time_capture.length);
+    UINT16_TO_STREAM(p, offset);
+    memcpy(p, &mesh_time_capture.buf[offset], len);
+    p += len;
+
+    mesh_time_transport_send(HCI_CONTROL_MESH_EVENT_TIME_CAPTURE_DATA, (uint8_t *)p_hci_event, (uint16_t)(p - (uint8_t *)p_hci_event));
+}
+#endif
+
+/*
+ * Send HCI event to the host. Events are recorded by the capture, except the capture data read
+ * by the host and the trace records which would fill the buffer.
+ */
+void mesh_time_transport_send(uint16_t opcode, uint8_t *p_data, uint16_t length)
+{
+#if MESH_TIME_CLIENT_CAPTURE
+    if ((opcode != HCI_CONTROL_MESH_EVENT_TIME_CAPTURE_DATA) && (opcode != HCI_CONTROL_MESH_EVENT_TIME_CLIENT_TRACE))
+        mesh_time_capture_write(MESH_TIME_CAPTURE_DIR_EVENT, opcode, p_data, length);
+#endif
+    mesh_transport_send_data(opcode, p_data, length);
+}
+
+/*
+ * Send Request Timeout event over transport for each host request waiting for the reply.
+ * The event contains the HCI command which has not been answered.
+ */
+void mesh_time_request_timeout_hci_event_send(mesh_time_request_t *p_request)
+{
+    wiced_bt_mesh_hci_event_t *p_hci_event;
+    uint8_t *p;
+    uint8_t  i;
+
+    // Report as if it comes from the server which did not reply
+    p_request->hdr.src = p_request->dst;
+
+    for (i = 0; i < p_request->num_waiters; i++)
+    {
+        if ((p_hci_event = mesh_time_hci_event_create(&p_request->hdr)) == NULL)
+            return;
+
+        p = p_hci_event->data;
+        UINT16_TO_STREAM(p, p_request->opcode);
+        mesh_time_transport_send(HCI_CONTROL_MESH_EVENT_TIME_REQUEST_TIMEOUT, (uint8_t *)p_hci_event, (uint16_t)(p - (uint8_t *)p_hci_event));
+    }
 }
 #endif
@@ -0,0 +1,93 @@
+/*
+* Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*/
+
+
+/** @file
+ *
+ * Mesh time client application interface for other code running on the device.
+ */
+#ifndef MESH_TIME_CLIENT_H
+#define MESH_TIME_CLIENT_H
+
+#include "wiced_bt_mesh_models.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Broken-down calendar time */
+typedef struct
+{
+    uint16_t    year;           /**< Year, for example 2024 */
+    uint8_t     month;          /**< Month 1..12 */
+    uint8_t     day;            /**< Day of the month 1..31 */
+    uint8_t     hour;           /**< Hour 0..23 */
+    uint8_t     minute;         /**< Minute 0..59 */
+    uint8_t     second;         /**< Second 0..60, 60 during the inserted leap second */
+    uint8_t     weekday;        /**< Day of the week 0..6, 0 is Sunday */
+} mesh_time_client_date_t;
+
+/**
+ * Get current mesh time interpolated from the last accepted Time Status and the local clock.
+ * The function does not send any mesh messages, executes in constant time and does not modify
+ * the client state. It reads the 64-bit clock state without locking, so it shall be called from
+ * the application thread, which also runs the timers and the mesh callbacks that update it.
+ *
+ * @param       p_time : TAI seconds, subsecond (1/256 s), uncertainty (10 ms units) grown by the
+ *                       time elapsed since the last update, time authority, TAI-UTC delta and time
+ *                       zone offset of the time source
+ *
+ * @return      WICED_TRUE if the time is known, WICED_FALSE if no Time Status has been accepted yet
+ */
+wiced_bool_t mesh_time_client_get_time(wiced_bt_mesh_time_state_msg_t *p_time);
+
+/**
+ * Convert mesh TAI seconds to UTC and local time. TAI-UTC delta and time zone offset are taken
+ * from the received statuses, including the scheduled changes of the zone and of the delta, so
+ * that the conversion is correct before and after the change. The calendar is computed only when
+ * the day changes, the conversion of the time within the same day does not use divisions.
+ * Times before 2000-01-01T00:00:00 UTC or local are clamped to it.
+ *
+ * @param       tai_seconds : TAI seconds since 2000-01-01T00:00:00 TAI
+ * @param       p_utc       : UTC time, can be NULL
+ * @param       p_local     : Local time, can be NULL
+ *
+ * @return      None
+ */
+void mesh_time_client_tai_to_local(uint64_t tai_seconds, mesh_time_client_date_t *p_utc, mesh_time_client_date_t *p_local);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MESH_TIME_CLIENT_H */
@@ -0,0 +1,249 @@
+/*
+* Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*/
+
+
+/** @file
+ *
+ * Binary traces of the mesh time client.
+ *
+ * Each trace call writes a fixed size record with the trace ID and raw arguments into a ring
+ * buffer. The ring is drained later from a timer and sent to the host in the
+ * HCI_CONTROL_MESH_EVENT_TIME_CLIENT_TRACE event, so no formatting is done on the message path.
+ * The host tools include this file with MESH_TIME_TRACE_DECODER defined to get the table of the
+ * format strings indexed by the trace ID and mesh_time_trace_decode() which prints the records
+ * of the event as text.
+ *
+ * Event format: number of records (1 byte), number of records dropped because the ring was full
+ * (2 bytes), followed by the records. Each record is local time in milliseconds (4 bytes),
+ * trace ID (1 byte), level (1 byte) and 3 arguments (4 bytes each), little endian.
+ */
+#ifndef MESH_TIME_CLIENT_TRACE_H
+#define MESH_TIME_CLIENT_TRACE_H
+
+#define MESH_TIME_TRACE_LEVEL_NONE      0
+#define MESH_TIME_TRACE_LEVEL_ERROR     1
+#define MESH_TIME_TRACE_LEVEL_INFO      2
+#define MESH_TIME_TRACE_LEVEL_DEBUG     3
+
+// Compile time trace level, set by the makefile
+#ifndef MESH_TIME_CLIENT_TRACE_LEVEL
+#define MESH_TIME_CLIENT_TRACE_LEVEL    MESH_TIME_TRACE_LEVEL_ERROR
+#endif
+
+#define MESH_TIME_TRACE_RECORD_LEN      18      // Length of the record in the HCI event
+
+/*
+ * Trace IDs and format strings. New traces are added at the end so that the IDs of the
+ * existing traces do not change. Arguments are recorded as 32 bit values, %d is used for the
+ * signed ones, %u and %x for the others.
+ */
+#define MESH_TIME_TRACE_IDS(X) \
+    X(MSG,              "time clt msg:%u") \
+    X(UNKNOWN_EVENT,    "unknown event:%u") \
+    X(CMD,              "cmd_opcode 0x%02x") \
+    X(UNKNOWN_CMD,      "unknown cmd_opcode 0x%02x") \
+    X(BAD_HDR,          "bad hdr cmd_opcode 0x%02x") \
+    X(BAD_LEN,          "bad len cmd_opcode 0x%02x len:%u") \
+    X(NO_MEM,           "no mem opcode 0x%02x dst:%04x") \
+    X(TIME_GET,         "time get dst:%04x") \
+    X(TIME_SET,         "time set dst:%04x tai:%x") \
+    X(ZONE_GET,         "time zone get dst:%04x") \
+    X(ZONE_SET,         "time zone set dst:%04x offset_new:%x tai_of_zone_change:%x") \
+    X(DELTA_GET,        "tai_utc delta get dst:%04x") \
+    X(DELTA_SET,        "tai_utc delta set dst:%04x delta_new:%x tai_of_delta_change:%x") \
+    X(ROLE_GET,         "time role get dst:%04x") \
+    X(ROLE_SET,         "time role set dst:%04x role:%x") \
+    X(TIME_STATUS,      "time status TAI_seconds:%x subsecond:%x uncertainty:%x") \
+    X(TIME_STATUS_EXT,  "time status auth:%x tai_utc_delta_current:%x time_zone_offset_current:%x") \
+    X(ZONE_STATUS,      "time zone status current:%x new:%x TAI_of_zone_change:%x") \
+    X(DELTA_STATUS,     "tai_utc delta status current:%x new:%x tai_of_delta_change:%x") \
+    X(ROLE_STATUS,      "time role status role:%x") \
+    X(BATCH_GET,        "batch get num:%u timeout:%u") \
+    X(BATCH_COMPLETE,   "batch complete replied:%u of %u") \
+    X(CACHE_MISS,       "cache miss dst:%04x") \
+    X(CACHE_HIT,        "cache hit dst:%04x age:%u") \
+    X(SAMPLE,           "sample src:%04x delay:%u offset:%d") \
+    X(RANKING,          "ranking num:%u") \
+    X(SYNC_CONFIG,      "time sync config enabled:%u servers:%u") \
+    X(SYNC_START,       "time sync start servers:%u") \
+    X(SYNC_INTERVAL,    "time sync interval:%u drift:%d ppb") \
+    X(CLOCK_STEP,       "clock step:%d ms") \
+    X(CLOCK_UPDATE,     "clock src:%04x err:%d us freq:%d ppb") \
+    X(REQUEST_COALESCED, "request coalesced opcode:0x%02x dst:%04x waiters:%u") \
+    X(REQUEST_RETRY,    "request retry opcode:0x%02x dst:%04x retries:%u") \
+    X(REQUEST_TIMEOUT,  "request timeout opcode:0x%02x dst:%04x waiters:%u") \
+    X(COMMAND_BATCH,    "command batch commands:%u sent:%u queued:%u") \
+    X(PACE_CONFIG,      "pacing rate:%u burst:%u jitter:%u ms") \
+    X(PACE_DROP,        "pacing queue full opcode:0x%02x dst:%04x dropped:%u") \
+    X(LPN_DEFER,        "lpn defer opcode:0x%02x dst:%04x queued:%u") \
+    X(LPN_FLUSH,        "lpn flush gets:%u") \
+    X(PROXY_CONFIG,     "proxy lpns:%u update polls:%u") \
+    X(PROXY_UPDATE,     "proxy update lpn:%04x tai:%u residency:%u ms") \
+    X(ELECTION_START,   "election start candidates:%u relays:%u") \
+    X(ELECTION_RESULT,  "election authority:%04x relays:%u ranked:%u") \
+    X(ELECTION_DEGRADED, "election authority:%04x score:%u missed:%u") \
+    X(CAPTURE,          "capture enabled:%u records:%u dropped:%u") \
+    X(NVRAM_FAIL,       "nvram write failed id:%x result:%x") \
+    X(LPN_SLEEP_FAIL,   "lpn hid-off failed duration:%u result:%x") \
+    X(CMD_DUPLICATE,    "cmd_opcode 0x%02x not indexed, same as 0x%02x entry:%u")
+
+#define MESH_TIME_TRACE_ID_ENUM(name, format)       MESH_TIME_TRACE_ID_##name,
+#define MESH_TIME_TRACE_ID_FORMAT(name, format)     format,
+
+enum
+{
+    MESH_TIME_TRACE_IDS(MESH_TIME_TRACE_ID_ENUM)
+    MESH_TIME_TRACE_ID_MAX
+};
+
+#ifdef MESH_TIME_TRACE_DECODER
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+static const char *mesh_time_trace_format[MESH_TIME_TRACE_ID_MAX] =
+{
+    MESH_TIME_TRACE_IDS(MESH_TIME_TRACE_ID_FORMAT)
+};
+
+#define MESH_TIME_TRACE_LE16(p)     ((uint32_t)(p)[0] | ((uint32_t)(p)[1] << 8))
+#define MESH_TIME_TRACE_LE32(p)     (MESH_TIME_TRACE_LE16(p) | (MESH_TIME_TRACE_LE16((p) + 2) << 16))
+
+/*
+ * Print the record arguments with the trace format. Each conversion is printed with a literal
+ * format, %d receives the argument as signed, %u and %x as unsigned. Only the zero flag and
+ * the width are supported.
+ */
+static void mesh_time_trace_print(FILE *p_file, const char *p_format, const uint32_t *p_arg)
+{
+    const char *p = p_format;
+    const char *p_conv;
+    int zero;
+    int width;
+    int num = 0;
+
+    while ((p_conv = strchr(p, '%')) != NULL)
+    {
+        fwrite(p, 1, (size_t)(p_conv - p), p_file);
+        p = p_conv + 1;
+        zero = (*p == '0');
+        for (width = 0; (*p >= '0') && (*p <= '9'); p++)
+            width = width * 10 + (*p - '0');
+        if ((num == 3) || ((*p != 'd') && (*p != 'u') && (*p != 'x')))
+        {
+            fprintf(p_file, "?");
+            return;
+        }
+        if (*p == 'd')
+            fprintf(p_file, zero ? "%0*d" : "%*d", width, (int)(int32_t)p_arg[num]);
+        else if (*p == 'u')
+            fprintf(p_file, zero ? "%0*u" : "%*u", width, (unsigned)p_arg[num]);
+        else
+            fprintf(p_file, zero ? "%0*x" : "%*x", width, (unsigned)p_arg[num]);
+        num++;
+        p++;
+    }
+    fprintf(p_file, "%s", p);
+}
+
+/*
+ * Print the records of the HCI_CONTROL_MESH_EVENT_TIME_CLIENT_TRACE event data as text lines,
+ * one per record. Returns number of decoded records, or -1 if the event is truncated.
+ */
+static int mesh_time_trace_decode(const uint8_t *p_data, uint32_t length, FILE *p_file)
+{
+    static const char *level_name[] = { "NONE", "ERROR", "INFO", "DEBUG" };
+    const uint8_t *p;
+    uint32_t arg[3];
+    uint8_t  num_records;
+    uint8_t  id;
+    uint8_t  level;
+    int      i;
+
+    if (length < 3)
+        return -1;
+
+    num_records = p_data[0];
+    if (MESH_TIME_TRACE_LE16(p_data + 1) != 0)
+        fprintf(p_file, "time client trace: %u records dropped\n", (unsigned)MESH_TIME_TRACE_LE16(p_data + 1));
+
+    if (length < 3 + (uint32_t)num_records * MESH_TIME_TRACE_RECORD_LEN)
+        return -1;
+
+    for (i = 0, p = p_data + 3; i < num_records; i++, p += MESH_TIME_TRACE_RECORD_LEN)
+    {
+        id     = p[4];
+        level  = p[5];
+        arg[0] = MESH_TIME_TRACE_LE32(p + 6);
+        arg[1] = MESH_TIME_TRACE_LE32(p + 10);
+        arg[2] = MESH_TIME_TRACE_LE32(p + 14);
+        fprintf(p_file, "%10u %-5s ", (unsigned)MESH_TIME_TRACE_LE32(p), level_name[level & 3]);
+        if (id < MESH_TIME_TRACE_ID_MAX)
+            mesh_time_trace_print(p_file, mesh_time_trace_format[id], arg);
+        else
+            fprintf(p_file, "unknown trace id:%u args:%x %x %x", (unsigned)id, (unsigned)arg[0], (unsigned)arg[1], (unsigned)arg[2]);
+        fprintf(p_file, "\n");
+    }
+    return num_records;
+}
+#else
+
+void mesh_time_trace_write(uint8_t level, uint8_t id, uint32_t arg0, uint32_t arg1, uint32_t arg2);
+
+/*
+ * MESH_TIME_TRACE(level, id, arg0, arg1, arg2) with level ERROR, INFO or DEBUG and id without
+ * the MESH_TIME_TRACE_ID_ prefix. Traces above the compile time level are removed.
+ */
+#define MESH_TIME_TRACE(level, id, arg0, arg1, arg2)    MESH_TIME_TRACE_##level(MESH_TIME_TRACE_ID_##id, arg0, arg1, arg2)
+
+#if MESH_TIME_CLIENT_TRACE_LEVEL >= MESH_TIME_TRACE_LEVEL_ERROR
+#define MESH_TIME_TRACE_ERROR(id, arg0, arg1, arg2)     mesh_time_trace_write(MESH_TIME_TRACE_LEVEL_ERROR, id, (uint32_t)(arg0), (uint32_t)(arg1), (uint32_t)(arg2))
+#else
+#define MESH_TIME_TRACE_ERROR(id, arg0, arg1, arg2)
+#endif
+
+#if MESH_TIME_CLIENT_TRACE_LEVEL >= MESH_TIME_TRACE_LEVEL_INFO
+#define MESH_TIME_TRACE_INFO(id, arg0, arg1, arg2)      mesh_time_trace_write(MESH_TIME_TRACE_LEVEL_INFO, id, (uint32_t)(arg0), (uint32_t)(arg1), (uint32_t)(arg2))
+#else
+#define MESH_TIME_TRACE_INFO(id, arg0, arg1, arg2)
+#endif
+
+#if MESH_TIME_CLIENT_TRACE_LEVEL >= MESH_TIME_TRACE_LEVEL_DEBUG
+#define MESH_TIME_TRACE_DEBUG(id, arg0, arg1, arg2)     mesh_time_trace_write(MESH_TIME_TRACE_LEVEL_DEBUG, id, (uint32_t)(arg0), (uint32_t)(arg1), (uint32_t)(arg2))
+#else
+#define MESH_TIME_TRACE_DEBUG(id, arg0, arg1, arg2)
+#endif
+
+#endif /* MESH_TIME_TRACE_DECODER */
+
+#endif /* MESH_TIME_CLIENT_TRACE_H */